@@ -1,6 +1,7 @@
 #include "building.h"
 
 #include "building/building_state.h"
+#include "building/count.h"
 #include "building/properties.h"
 #include "building/rotation.h"
 #include "building/storage.h"
@@ -22,7 +23,16 @@
 
 #include <string.h>
 
-static building all_buildings[5000];
+static building all_buildings[MAX_BUILDING_SLOTS];
+
+// Buildings filed by type. Each list is kept sorted by id, so walking it visits the
+// buildings in the same order as a scan over all slots.
+static struct {
+    short first[int_MAX];
+    short next[MAX_BUILDING_SLOTS];
+    short prev[MAX_BUILDING_SLOTS];
+    short type[MAX_BUILDING_SLOTS]; // 0 if the building isn't filed
+} type_index;
 
 static struct {
     int highest_id_in_use;
@@ -41,6 +51,62 @@ int building_find(int type) {
     }
     return MAX_BUILDINGS[GAME_ENV];
 }
+static void type_index_remove(int id) {
+    int type = type_index.type[id];
+    if (!type)
+        return;
+    int prev = type_index.prev[id];
+    int next = type_index.next[id];
+    if (prev)
+        type_index.next[prev] = next;
+    else
+        type_index.first[type] = next;
+    if (next)
+        type_index.prev[next] = prev;
+    type_index.type[id] = 0;
+}
+static void type_index_add(int id, int type) {
+    if (type <= BUILDING_NONE || type >= int_MAX)
+        return;
+    int prev = 0;
+    int next = type_index.first[type];
+    while (next && next < id) {
+        prev = next;
+        next = type_index.next[next];
+    }
+    type_index.prev[id] = prev;
+    type_index.next[id] = next;
+    if (prev)
+        type_index.next[prev] = id;
+    else
+        type_index.first[type] = id;
+    if (next)
+        type_index.prev[next] = id;
+    type_index.type[id] = type;
+}
+static void type_index_rebuild(void) {
+    memset(&type_index, 0, sizeof(type_index));
+    // adding in descending order makes every insert a push to the front
+    for (int i = MAX_BUILDINGS[GAME_ENV] - 1; i > 0; i--) {
+        if (all_buildings[i].state != BUILDING_STATE_UNUSED)
+            type_index_add(i, all_buildings[i].type);
+    }
+}
+building *building_first_of_type(int type) {
+    if (type <= BUILDING_NONE || type >= int_MAX || !type_index.first[type])
+        return 0;
+    return &all_buildings[type_index.first[type]];
+}
+building *building_next_of_type(building *b) {
+    int next = type_index.next[b->id];
+    return next ? &all_buildings[next] : 0;
+}
+void building_update_type_index(building *b) {
+    if (type_index.type[b->id] == b->type)
+        return;
+    type_index_remove(b->id);
+    type_index_add(b->id, b->type);
+}
 building *building_get(int id) {
     return &all_buildings[id];
 }
@@ -92,6 +158,8 @@ building *building_create(int type, int x, int y) {
     b->type = type;
     b->size = props->size;
     b->creation_sequence_index = extra.created_sequence++;
+    type_index_remove(b->id);
+    type_index_add(b->id, type);
     b->sentiment.house_happiness = 50;
     b->distance_from_entry = 0;
 
@@ -302,8 +370,10 @@ building *building_create(int type, int x, int y) {
 static void building_delete(building *b) {
     building_clear_related_data(b);
     int id = b->id;
+    type_index_remove(id);
     memset(b, 0, sizeof(building));
     b->id = id;
+    building_count_refresh(b);
 }
 void building_clear_related_data(building *b) {
     if (b->storage_id)
@@ -337,6 +407,8 @@ void building_clear_all(void) {
         memset(&all_buildings[i], 0, sizeof(building));
         all_buildings[i].id = i;
     }
+    memset(&type_index, 0, sizeof(type_index));
+    building_count_invalidate();
     extra.highest_id_in_use = 0;
     extra.highest_id_ever = 0;
     extra.created_sequence = 0;
@@ -440,8 +512,10 @@ void building_update_state(void) {
     int aqueduct_recalc = 0;
     for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
         building *b = &all_buildings[i];
-        if (b->state == BUILDING_STATE_CREATED)
+        if (b->state == BUILDING_STATE_CREATED) {
             b->state = BUILDING_STATE_VALID;
+            building_count_refresh(b);
+        }
 
         if (b->state != BUILDING_STATE_VALID || !b->house_size) {
             if (b->state == BUILDING_STATE_UNDO || b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
@@ -519,6 +593,7 @@ int building_mothball_toggle(building *b) {
     } else if (b->state == BUILDING_STATE_MOTHBALLED)
         b->state = BUILDING_STATE_VALID;
 
+    building_count_refresh(b);
     return b->state;
 
 }
@@ -531,6 +606,7 @@ int building_mothball_set(building *b, int mothball) {
     } else if (b->state == BUILDING_STATE_MOTHBALLED)
         b->state = BUILDING_STATE_VALID;
 
+    building_count_refresh(b);
     return b->state;
 
 }
@@ -554,6 +630,8 @@ void building_load_state(buffer *buf, buffer *highest_id, buffer *highest_id_eve
         building_state_load_from_buffer(buf, &all_buildings[i]);
         all_buildings[i].id = i;
     }
+    type_index_rebuild();
+    building_count_invalidate();
     extra.highest_id_in_use = highest_id->read_i32();
     extra.highest_id_ever = highest_id_ever->read_i32();
     highest_id_ever->skip(4);
@@ -9,6 +9,8 @@ static const int MAX_BUILDINGS[2] = {
         2000,
         4000
 };
+// storage for building slots, enough for the largest MAX_BUILDINGS
+#define MAX_BUILDING_SLOTS 5000
 
 typedef struct {
     int id;
@@ -169,6 +171,27 @@ typedef struct {
 
 int building_find(int type);
 building *building_get(int id);
+
+/**
+ * Gets the first building of a type, to walk all buildings of that type in id order
+ * with building_next_of_type. The buildings are filed by building_create, deletion and
+ * loading; code that changes b->type afterwards (house evolution, fires) doesn't re-file,
+ * so only use this for types that don't change and still check state and type.
+ * @param type Building type
+ * @return Building with the lowest id of that type, or 0 if there is none
+ */
+building *building_first_of_type(int type);
+/**
+ * Gets the next building filed under the same type
+ * @param b Building returned by building_first_of_type or building_next_of_type
+ * @return Next building, or 0 at the end of the list
+ */
+building *building_next_of_type(building *b);
+/**
+ * Files a building under its current type after its data was restored wholesale
+ * @param b Building
+ */
+void building_update_type_index(building *b);
 building *building_main(building *b);
 building *building_next(building *b);
 building *building_top_xy(building *b);
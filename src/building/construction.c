@@ -30,6 +30,7 @@
 #include "map/bridge.h"
 #include "map/building.h"
 #include "map/building_tiles.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/image.h"
 #include "map/orientation.h"
@@ -1672,6 +1673,7 @@ void building_construction_place(void) { // confirm final placement
     city_finance_process_construction(placement_cost);
     game_undo_finish_build(placement_cost);
     map_tiles_update_region_empty_land(x_start - 2, y_start - 2, x_end + 2, y_end + 2);
+    map_desirability_update_changed();
 }
 
 static void set_warning(int *warning_id, int warning) {
@@ -1,6 +1,7 @@
 #include "construction_clear.h"
 
 #include "building/building.h"
+#include "building/count.h"
 #include "city/warning.h"
 #include "core/config.h"
 #include "figuretype/migrant.h"
@@ -96,6 +97,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                     game_undo_add_building(b);
                 }
                 b->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                building_count_refresh(b);
                 b->is_deleted = 1;
                 building *space = b;
                 for (int i = 0; i < 99; i++) {
@@ -104,6 +106,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                     space = building_get(space->prev_part_building_id);
                     game_undo_add_building(space);
                     space->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                    building_count_refresh(space);
                 }
                 space = b;
                 for (int i = 0; i < 9; i++) {
@@ -112,6 +115,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                         break;
                     game_undo_add_building(space);
                     space->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                    building_count_refresh(space);
                 }
             } else if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
                 map_terrain_remove(grid_offset, TERRAIN_CLEARABLE);
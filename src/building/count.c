@@ -4,8 +4,11 @@
 #include "city/buildings.h"
 #include "city/health.h"
 #include "figure/figure.h"
+#include "core/config.h"
 #include "core/game_environment.h"
+#include "core/log.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 struct record {
@@ -13,24 +16,34 @@ struct record {
     int total;
 };
 
-static struct {
+struct counters {
     struct record buildings[int_MAX];
     struct record industry[36];
-} data;
+};
 
-static void clear_counters(void) {
-    memset(&data, 0, sizeof(data));
-}
-static void increase_count(int type, int active) {
-    ++data.buildings[type].total;
-    if (active)
-        ++data.buildings[type].active;
+// what a single building adds to the counters
+typedef struct {
+    short type;
+    short resource;
+    unsigned char active;
+} contribution;
 
+static struct counters data;
+
+// counters kept current as buildings change, see building_count_refresh
+static struct {
+    int valid;
+    struct counters live;
+    contribution counted[MAX_BUILDING_SLOTS];
+} incremental;
+
+static void clear_counters(struct counters *counters) {
+    memset(counters, 0, sizeof(struct counters));
 }
-static void increase_industry_count(int resource, int active) {
-    ++data.industry[resource].total;
+static void increase_count(struct record *record, int active, int amount) {
+    record->total += amount;
     if (active)
-        ++data.industry[resource].active;
+        record->active += amount;
 
 }
 
@@ -41,205 +54,306 @@ static void limit_hippodrome(void) {
         data.buildings[BUILDING_HIPPODROME].active = 1;
 }
 
+static void update_entertainment_venue(building *b) {
+    int is_entertainment_venue = 0;
+    int type = b->type;
+    switch (type) {
+        // SPECIAL TREATMENT
+        // entertainment venues
+        case BUILDING_THEATER:
+        case BUILDING_AMPHITHEATER:
+        case BUILDING_COLOSSEUM:
+        case BUILDING_HIPPODROME:
+            is_entertainment_venue = 1;
+            break;
+    }
+    if (is_entertainment_venue) {
+        // update number of shows
+        int shows = 0;
+        if (b->data.entertainment.days1 > 0) {
+            --b->data.entertainment.days1;
+            ++shows;
+        }
+        if (b->data.entertainment.days2 > 0) {
+            --b->data.entertainment.days2;
+            ++shows;
+        }
+        if (type != BUILDING_THEATER && b->data.entertainment.days3_or_play > 0) {
+            --b->data.entertainment.days3_or_play;
+            ++shows;
+        }
+        b->data.entertainment.num_shows = shows;
+    }
+}
+building_sweep_job building_entertainment_update_job(void) {
+    building_sweep_job job = {0, update_entertainment_venue, 0, BUILDING_SWEEP_NON_HOUSES};
+    return job;
+}
 void building_entertainment_update() {
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_VALID || b->house_size)
-            continue;
+    building_sweep_job job = building_entertainment_update_job();
+    building_sweep_run(&job, 1);
+}
+
+static contribution get_contribution(building *b) {
+    contribution c = {BUILDING_NONE, RESOURCE_NONE, 0};
+    if (b->state != BUILDING_STATE_VALID || b->house_size)
+        return c;
+
+    int type = b->type;
+    switch (type) {
+        // water
+        case BUILDING_RESERVOIR:
+        case BUILDING_FOUNTAIN:
+            c.type = type;
+            c.active = b->has_water_access != 0;
+            break;
 
-        int is_entertainment_venue = 0;
-        int type = b->type;
-        switch (type) {
-            // SPECIAL TREATMENT
             // entertainment venues
-            case BUILDING_THEATER:
-            case BUILDING_AMPHITHEATER:
-            case BUILDING_COLOSSEUM:
-            case BUILDING_HIPPODROME:
-                is_entertainment_venue = 1;
-                break;
-        }
-        if (is_entertainment_venue) {
-            // update number of shows
-            int shows = 0;
-            if (b->data.entertainment.days1 > 0) {
-                --b->data.entertainment.days1;
-                ++shows;
-            }
-            if (b->data.entertainment.days2 > 0) {
-                --b->data.entertainment.days2;
-                ++shows;
-            }
-            if (type != BUILDING_THEATER && b->data.entertainment.days3_or_play > 0) {
-                --b->data.entertainment.days3_or_play;
-                ++shows;
-            }
-            b->data.entertainment.num_shows = shows;
-        }
+        case BUILDING_THEATER:
+        case BUILDING_AMPHITHEATER:
+        case BUILDING_COLOSSEUM:
+        case BUILDING_HIPPODROME:
+            // education
+        case BUILDING_SCHOOL:
+        case BUILDING_LIBRARY:
+        case BUILDING_ACADEMY:
+            // health
+        case BUILDING_BARBER:
+        case BUILDING_BATHHOUSE:
+        case BUILDING_DOCTOR:
+        case BUILDING_HOSPITAL:
+            // government
+        case BUILDING_FORUM:
+        case BUILDING_FORUM_UPGRADED:
+        case BUILDING_SENATE:
+        case BUILDING_SENATE_UPGRADED:
+            // entertainment schools
+        case BUILDING_ACTOR_COLONY:
+        case BUILDING_GLADIATOR_SCHOOL:
+        case BUILDING_LION_HOUSE:
+        case BUILDING_CHARIOT_MAKER:
+            // distribution
+        case BUILDING_MARKET:
+            // military
+        case BUILDING_BARRACKS:
+        case BUILDING_MILITARY_ACADEMY:
+            // religion
+        case BUILDING_SMALL_TEMPLE_CERES:
+        case BUILDING_SMALL_TEMPLE_NEPTUNE:
+        case BUILDING_SMALL_TEMPLE_MERCURY:
+        case BUILDING_SMALL_TEMPLE_MARS:
+        case BUILDING_SMALL_TEMPLE_VENUS:
+        case BUILDING_LARGE_TEMPLE_CERES:
+        case BUILDING_LARGE_TEMPLE_NEPTUNE:
+        case BUILDING_LARGE_TEMPLE_MERCURY:
+        case BUILDING_LARGE_TEMPLE_MARS:
+        case BUILDING_LARGE_TEMPLE_VENUS:
+        case BUILDING_ORACLE:
+            c.type = type;
+            c.active = b->num_workers > 0;
+            break;
+
+        case BUILDING_SHRINE_OSIRIS:
+        case BUILDING_SHRINE_RA:
+        case BUILDING_SHRINE_PTAH:
+        case BUILDING_SHRINE_SETH:
+        case BUILDING_SHRINE_BAST:
+            c.type = type;
+            c.active = b->has_road_access > 0;
+            break;
+
+            // industry
+        case BUILDING_WHEAT_FARM:
+            c.resource = RESOURCE_WHEAT;
+            break;
+        case BUILDING_VEGETABLE_FARM:
+            c.resource = RESOURCE_VEGETABLES;
+            break;
+        case BUILDING_FRUIT_FARM:
+            c.resource = RESOURCE_FRUIT;
+            break;
+        case BUILDING_OLIVE_FARM:
+            c.resource = RESOURCE_OLIVES;
+            break;
+        case BUILDING_VINES_FARM:
+            c.resource = RESOURCE_VINES;
+            break;
+        case BUILDING_PIG_FARM:
+            c.resource = RESOURCE_MEAT_C3;
+            break;
+        case BUILDING_MARBLE_QUARRY:
+            c.resource = RESOURCE_MARBLE_C3;
+            break;
+        case BUILDING_IRON_MINE:
+            c.resource = RESOURCE_IRON;
+            break;
+        case BUILDING_TIMBER_YARD:
+            c.resource = RESOURCE_TIMBER_C3;
+            break;
+        case BUILDING_CLAY_PIT:
+            c.resource = RESOURCE_CLAY;
+            break;
+        case BUILDING_WINE_WORKSHOP:
+            c.resource = RESOURCE_WINE;
+            break;
+        case BUILDING_OIL_WORKSHOP:
+            c.resource = RESOURCE_OIL_C3;
+            break;
+        case BUILDING_WEAPONS_WORKSHOP:
+            c.resource = RESOURCE_WEAPONS_C3;
+            break;
+        case BUILDING_FURNITURE_WORKSHOP:
+            c.resource = RESOURCE_FURNITURE;
+            break;
+        case BUILDING_POTTERY_WORKSHOP:
+            c.resource = RESOURCE_POTTERY_C3;
+            break;
     }
+    if (c.resource)
+        c.active = b->num_workers > 0;
+    return c;
 }
-void building_count_update(void) {
-    clear_counters();
-    city_buildings_reset_dock_wharf_counters();
-    city_health_reset_hospital_workers();
+static void add_contribution(struct counters *counters, const contribution *c, int amount) {
+    if (c->type) {
+        increase_count(&counters->buildings[c->type], c->active, amount);
+        // an amphitheater also counts as a theater, a colosseum as both
+        if (c->type == BUILDING_AMPHITHEATER || c->type == BUILDING_COLOSSEUM)
+            increase_count(&counters->buildings[BUILDING_THEATER], c->active, amount);
+        if (c->type == BUILDING_COLOSSEUM)
+            increase_count(&counters->buildings[BUILDING_AMPHITHEATER], c->active, amount);
+    }
+    if (c->resource)
+        increase_count(&counters->industry[c->resource], c->active, amount);
+}
+
+// city-wide values that the count update collects on the side
+static void update_related_data(building *b, const contribution *c) {
+    switch (b->type) {
+        case BUILDING_BARRACKS:
+            city_buildings_set_barracks(b->id);
+            break;
+        case BUILDING_HOSPITAL:
+            city_health_add_hospital_workers(b->num_workers);
+            break;
+        case BUILDING_WHARF:
+            if (b->num_workers > 0)
+                city_buildings_add_working_wharf(!b->data.industry.fishing_boat_id);
 
+            break;
+        case BUILDING_DOCK:
+            if (b->num_workers > 0 && b->has_water_access)
+                city_buildings_add_working_dock(b->id);
+
+            break;
+        default:
+            if (!c->type && !c->resource)
+                return;
+            break;
+    }
+    if (b->immigrant_figure_id) {
+        figure *f = figure_get(b->immigrant_figure_id);
+        if (f->state != FIGURE_STATE_ALIVE || f->destination_building_id != b->id)
+            b->immigrant_figure_id = 0;
+    }
+}
+
+static void count_all_buildings(struct counters *counters) {
+    clear_counters(counters);
     for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
         building *b = building_get(i);
-        if (b->state != BUILDING_STATE_VALID || b->house_size)
-            continue;
+        contribution c = get_contribution(b);
+        add_contribution(counters, &c, 1);
+        incremental.counted[i] = c;
+    }
+}
+static void check_live_counters(void) {
+    struct counters *rescanned = (struct counters *) malloc(sizeof(struct counters));
+    if (!rescanned)
+        return;
+    count_all_buildings(rescanned);
+    for (int type = 0; type < int_MAX; type++) {
+        if (memcmp(&rescanned->buildings[type], &incremental.live.buildings[type], sizeof(struct record)) != 0)
+            log_error("Building count out of date for type", 0, type);
+    }
+    for (int resource = 0; resource < RESOURCE_MAX[GAME_ENV]; resource++) {
+        if (memcmp(&rescanned->industry[resource], &incremental.live.industry[resource], sizeof(struct record)) != 0)
+            log_error("Industry count out of date for resource", 0, resource);
+    }
+    incremental.live = *rescanned;
+    free(rescanned);
+}
+static void update_incremental(void) {
+    if (!incremental.valid) {
+        count_all_buildings(&incremental.live);
+        incremental.valid = 1;
+    } else if (DEBUG_MODE == ENGINE_MODE_DEBUG) {
+        check_live_counters();
+    }
+    data = incremental.live;
+    if (GAME_ENV == ENGINE_ENV_C3)
+        limit_hippodrome();
 
-        int type = b->type;
-        switch (type) {
-            // SPECIAL TREATMENT
-            // entertainment venues
-            case BUILDING_THEATER:
-                increase_count(type, b->num_workers > 0);
-                break;
-            case BUILDING_AMPHITHEATER:
-                increase_count(type, b->num_workers > 0);
-                increase_count(BUILDING_THEATER, b->num_workers > 0);
-                break;
-            case BUILDING_COLOSSEUM:
-                increase_count(type, b->num_workers > 0);
-                increase_count(BUILDING_AMPHITHEATER, b->num_workers > 0);
-                increase_count(BUILDING_THEATER, b->num_workers > 0);
-                break;
-            case BUILDING_HIPPODROME:
-                increase_count(type, b->num_workers > 0);
-                break;
-
-            case BUILDING_BARRACKS:
-                city_buildings_set_barracks(i);
-                increase_count(type, b->num_workers > 0);
-                break;
-
-            case BUILDING_HOSPITAL:
-                increase_count(type, b->num_workers > 0);
-                city_health_add_hospital_workers(b->num_workers);
-                break;
-
-                // water
-            case BUILDING_RESERVOIR:
-            case BUILDING_FOUNTAIN:
-                increase_count(type, b->has_water_access);
-                break;
-
-                // DEFAULT TREATMENT
-                // education
-            case BUILDING_SCHOOL:
-            case BUILDING_LIBRARY:
-            case BUILDING_ACADEMY:
-                // health
-            case BUILDING_BARBER:
-            case BUILDING_BATHHOUSE:
-            case BUILDING_DOCTOR:
-                // government
-            case BUILDING_FORUM:
-            case BUILDING_FORUM_UPGRADED:
-            case BUILDING_SENATE:
-            case BUILDING_SENATE_UPGRADED:
-                // entertainment schools
-            case BUILDING_ACTOR_COLONY:
-            case BUILDING_GLADIATOR_SCHOOL:
-            case BUILDING_LION_HOUSE:
-            case BUILDING_CHARIOT_MAKER:
-                // distribution
-            case BUILDING_MARKET:
-                // military
-            case BUILDING_MILITARY_ACADEMY:
-                // religion
-            case BUILDING_SMALL_TEMPLE_CERES:
-            case BUILDING_SMALL_TEMPLE_NEPTUNE:
-            case BUILDING_SMALL_TEMPLE_MERCURY:
-            case BUILDING_SMALL_TEMPLE_MARS:
-            case BUILDING_SMALL_TEMPLE_VENUS:
-            case BUILDING_LARGE_TEMPLE_CERES:
-            case BUILDING_LARGE_TEMPLE_NEPTUNE:
-            case BUILDING_LARGE_TEMPLE_MERCURY:
-            case BUILDING_LARGE_TEMPLE_MARS:
-            case BUILDING_LARGE_TEMPLE_VENUS:
-            case BUILDING_ORACLE:
-                increase_count(type, b->num_workers > 0);
-                break;
-
-            case BUILDING_SHRINE_OSIRIS:
-            case BUILDING_SHRINE_RA:
-            case BUILDING_SHRINE_PTAH:
-            case BUILDING_SHRINE_SETH:
-            case BUILDING_SHRINE_BAST:
-                increase_count(type, b->has_road_access > 0);
-                break;
-
-                // industry
-            case BUILDING_WHEAT_FARM:
-                increase_industry_count(RESOURCE_WHEAT, b->num_workers > 0);
-                break;
-            case BUILDING_VEGETABLE_FARM:
-                increase_industry_count(RESOURCE_VEGETABLES, b->num_workers > 0);
-                break;
-            case BUILDING_FRUIT_FARM:
-                increase_industry_count(RESOURCE_FRUIT, b->num_workers > 0);
-                break;
-            case BUILDING_OLIVE_FARM:
-                increase_industry_count(RESOURCE_OLIVES, b->num_workers > 0);
-                break;
-            case BUILDING_VINES_FARM:
-                increase_industry_count(RESOURCE_VINES, b->num_workers > 0);
-                break;
-            case BUILDING_PIG_FARM:
-                increase_industry_count(RESOURCE_MEAT_C3, b->num_workers > 0);
-                break;
-            case BUILDING_MARBLE_QUARRY:
-                increase_industry_count(RESOURCE_MARBLE_C3, b->num_workers > 0);
-                break;
-            case BUILDING_IRON_MINE:
-                increase_industry_count(RESOURCE_IRON, b->num_workers > 0);
-                break;
-            case BUILDING_TIMBER_YARD:
-                increase_industry_count(RESOURCE_TIMBER_C3, b->num_workers > 0);
-                break;
-            case BUILDING_CLAY_PIT:
-                increase_industry_count(RESOURCE_CLAY, b->num_workers > 0);
-                break;
-            case BUILDING_WINE_WORKSHOP:
-                increase_industry_count(RESOURCE_WINE, b->num_workers > 0);
-                break;
-            case BUILDING_OIL_WORKSHOP:
-                increase_industry_count(RESOURCE_OIL_C3, b->num_workers > 0);
-                break;
-            case BUILDING_WEAPONS_WORKSHOP:
-                increase_industry_count(RESOURCE_WEAPONS_C3, b->num_workers > 0);
-                break;
-            case BUILDING_FURNITURE_WORKSHOP:
-                increase_industry_count(RESOURCE_FURNITURE, b->num_workers > 0);
-                break;
-            case BUILDING_POTTERY_WORKSHOP:
-                increase_industry_count(RESOURCE_POTTERY_C3, b->num_workers > 0);
-                break;
-
-                // water-side
-            case BUILDING_WHARF:
-                if (b->num_workers > 0)
-                    city_buildings_add_working_wharf(!b->data.industry.fishing_boat_id);
-
-                break;
-            case BUILDING_DOCK:
-                if (b->num_workers > 0 && b->has_water_access)
-                    city_buildings_add_working_dock(i);
-
-                break;
-            default:
+    city_buildings_reset_dock_wharf_counters();
+    city_health_reset_hospital_workers();
+    // walking the non-house types visits the same buildings in the same order per type as a full scan
+    for (int type = BUILDING_NONE + 1; type < int_MAX; type++) {
+        if (building_is_house(type))
+            continue;
+        for (building *b = building_first_of_type(type); b; b = building_next_of_type(b)) {
+            if (b->type != type)
                 continue;
-        }
-        if (b->immigrant_figure_id) {
-            figure *f = figure_get(b->immigrant_figure_id);
-            if (f->state != FIGURE_STATE_ALIVE || f->destination_building_id != i)
-                b->immigrant_figure_id = 0;
+            contribution c = get_contribution(b);
+            if (b->state == BUILDING_STATE_VALID && !b->house_size)
+                update_related_data(b, &c);
         }
     }
+}
+static void begin_full_count(void) {
+    incremental.valid = 0;
+    clear_counters(&data);
+    city_buildings_reset_dock_wharf_counters();
+    city_health_reset_hospital_workers();
+}
+static void count_building(building *b) {
+    contribution c = get_contribution(b);
+    add_contribution(&data, &c, 1);
+    update_related_data(b, &c);
+}
+static void end_full_count(void) {
     if (GAME_ENV == ENGINE_ENV_C3)
         limit_hippodrome();
 }
+building_sweep_job building_count_update_job(void) {
+    if (config_get(CONFIG_GP_CH_INCREMENTAL_BUILDING_COUNTS)) {
+        // the counts are current, only the work on the side is left
+        building_sweep_job job = {update_incremental, 0, 0, BUILDING_SWEEP_NON_HOUSES};
+        return job;
+    }
+    building_sweep_job job = {begin_full_count, count_building, end_full_count, BUILDING_SWEEP_NON_HOUSES};
+    return job;
+}
+void building_count_update(void) {
+    building_sweep_job job = building_count_update_job();
+    building_sweep_run(&job, 1);
+}
+void building_count_refresh(building *b) {
+    if (!incremental.valid)
+        return;
+    contribution c = get_contribution(b);
+    contribution *counted = &incremental.counted[b->id];
+    if (c.type == counted->type && c.resource == counted->resource && c.active == counted->active)
+        return;
+    add_contribution(&incremental.live, counted, -1);
+    add_contribution(&incremental.live, &c, 1);
+    *counted = c;
+
+    data = incremental.live;
+    if (GAME_ENV == ENGINE_ENV_C3)
+        limit_hippodrome();
+}
+void building_count_invalidate(void) {
+    incremental.valid = 0;
+}
 int building_count_active(int type) {
     return data.buildings[type].active;
 }
@@ -2,6 +2,8 @@
 #define BUILDING_COUNT_H
 
 #include "core/buffer.h"
+#include "building/building.h"
+#include "building/sweep.h"
 #include "building/type.h"
 #include "game/resource.h"
 
@@ -11,11 +13,39 @@
  */
 
 /**
- * Updates the building counts and does some extra work on the side
+ * Counts down the show days of the entertainment venues
  */
 void building_entertainment_update();
+
+/**
+ * Gets the entertainment venue update as a job, to run it in the same pass as other building jobs
+ * @return Sweep job
+ */
+building_sweep_job building_entertainment_update_job(void);
+
+/**
+ * Updates the building counts and does some extra work on the side
+ */
 void building_count_update(void);
 
+/**
+ * Gets the building count update as a job, to run it in the same pass as other building jobs
+ * @return Sweep job
+ */
+building_sweep_job building_count_update_job(void);
+
+/**
+ * Brings the counts up to date after the state, type, workers or access of a building changed.
+ * Only does anything while the incremental building counts gameplay option keeps the counts current.
+ * @param b Building that changed
+ */
+void building_count_refresh(building *b);
+
+/**
+ * Makes the next count update recount all buildings, for when buildings were replaced wholesale
+ */
+void building_count_invalidate(void);
+
 /**
  * Returns the active building count for the type
  * @param type Building type
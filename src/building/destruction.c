@@ -1,5 +1,6 @@
 #include "destruction.h"
 
+#include "building/count.h"
 #include "city/message.h"
 #include "city/population.h"
 #include "city/ratings.h"
@@ -66,6 +67,7 @@ static void destroy_on_fire(building *b, int plagued) {
         }
         map_building_tiles_add(b->id, b->x, b->y, 1, image_id, TERRAIN_BUILDING);
     }
+    building_count_refresh(b);
     static const int x_tiles[] = {0, 1, 1, 0, 2, 2, 2, 1, 0, 3, 3, 3, 3, 2, 1, 0, 4, 4, 4, 4, 4, 3, 2, 1, 0, 5, 5, 5, 5,
                                   5, 5, 4, 3, 2, 1, 0};
     static const int y_tiles[] = {0, 0, 1, 1, 0, 1, 2, 2, 2, 0, 1, 2, 3, 3, 3, 3, 0, 1, 2, 3, 4, 4, 4, 4, 4, 0, 1, 2, 3,
@@ -111,6 +113,7 @@ static void destroy_linked_parts(building *b, int on_fire) {
         else {
             map_building_tiles_set_rubble(part_id, part->x, part->y, part->size);
             part->state = BUILDING_STATE_RUBBLE;
+            building_count_refresh(part);
         }
     }
 
@@ -125,12 +128,14 @@ static void destroy_linked_parts(building *b, int on_fire) {
         else {
             map_building_tiles_set_rubble(part->id, part->x, part->y, part->size);
             part->state = BUILDING_STATE_RUBBLE;
+            building_count_refresh(part);
         }
     }
 }
 
 void building_destroy_by_collapse(building *b) {
     b->state = BUILDING_STATE_RUBBLE;
+    building_count_refresh(b);
     map_building_tiles_set_rubble(b->id, b->x, b->y, b->size);
     figure_create_explosion_cloud(b->x, b->y, b->size);
     destroy_linked_parts(b, 0);
@@ -153,6 +158,7 @@ int building_destroy_first_of_type(int type) {
         int grid_offset = b->grid_offset;
         game_undo_disable();
         b->state = BUILDING_STATE_RUBBLE;
+        building_count_refresh(b);
         map_building_tiles_set_rubble(i, b->x, b->y, b->size);
         sound_effect_play(SOUND_EFFECT_EXPLOSION);
         map_routing_update_land();
@@ -2,6 +2,7 @@
 #include "building/figure.h"
 
 #include "building/barracks.h"
+#include "building/count.h"
 #include "building/granary.h"
 #include "building/industry.h"
 #include "building/market.h"
@@ -1010,6 +1011,7 @@ static void spawn_figure_industry(building *b) {
                 b->data.industry.labor_state = 0;
                 b->data.industry.labor_days_left = 0;
                 b->num_workers = 0;
+                building_count_refresh(b);
             }
         }
     }
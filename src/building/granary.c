@@ -216,8 +216,8 @@ void building_granaries_calculate_stocks(void) {
     non_getting_granaries.total_storage_fruit = 0;
     non_getting_granaries.total_storage_meat = 0;
 
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = building_next_of_type(b)) {
+        int i = b->id;
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_GRANARY)
             continue;
 
@@ -262,8 +262,8 @@ int building_granary_for_storing(int x, int y, int resource, int distance_from_e
 
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = building_next_of_type(b)) {
+        int i = b->id;
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_GRANARY)
             continue;
 
@@ -316,8 +316,8 @@ int building_getting_granary_for_storing(int x, int y, int resource, int distanc
 
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = building_next_of_type(b)) {
+        int i = b->id;
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_GRANARY)
             continue;
 
@@ -414,8 +414,7 @@ int building_granary_for_getting(building *src, map_point *dst) {
 void building_granary_bless(void) {
     int min_stored = INFINITE;
     building *min_building = 0;
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = building_next_of_type(b)) {
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_GRANARY)
             continue;
 
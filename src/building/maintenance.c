@@ -1,6 +1,7 @@
 #include "maintenance.h"
 
 #include "building/building.h"
+#include "building/count.h"
 #include "building/destruction.h"
 #include "building/list.h"
 #include "city/buildings.h"
@@ -50,6 +51,7 @@ void building_maintenance_update_burning_ruins(void) {
         if (b->fire_duration > 32) {
             game_undo_disable();
             b->state = BUILDING_STATE_RUBBLE;
+            building_count_refresh(b);
             map_building_tiles_set_rubble(i, b->x, b->y, b->size);
             recalculate_terrain = 1;
             continue;
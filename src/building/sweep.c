@@ -0,0 +1,40 @@
+#include "sweep.h"
+
+#include "core/game_environment.h"
+
+static int wants_building(const building_sweep_job *job, const building *b) {
+    // an earlier job may have changed the state of the building
+    if (!job->visit || b->state != BUILDING_STATE_VALID)
+        return 0;
+    switch (job->buildings) {
+        case BUILDING_SWEEP_HOUSES:
+            return b->house_size != 0;
+        case BUILDING_SWEEP_NON_HOUSES:
+            return b->house_size == 0;
+        default:
+            return 1;
+    }
+}
+
+void building_sweep_run(const building_sweep_job *jobs, int num_jobs) {
+    int has_visitors = 0;
+    for (int j = 0; j < num_jobs; j++) {
+        if (jobs[j].begin)
+            jobs[j].begin();
+        if (jobs[j].visit)
+            has_visitors = 1;
+    }
+    if (has_visitors) {
+        for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
+            building *b = building_get(i);
+            for (int j = 0; j < num_jobs; j++) {
+                if (wants_building(&jobs[j], b))
+                    jobs[j].visit(b);
+            }
+        }
+    }
+    for (int j = 0; j < num_jobs; j++) {
+        if (jobs[j].end)
+            jobs[j].end();
+    }
+}
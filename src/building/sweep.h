@@ -0,0 +1,40 @@
+#ifndef BUILDING_SWEEP_H
+#define BUILDING_SWEEP_H
+
+#include "building/building.h"
+
+/**
+ * @file
+ * Runs several per-building jobs in a single pass over the building slots.
+ *
+ * Fusing jobs gives the same result as running them one after another as long as every job
+ * only changes the building it visits and its own totals, and doesn't read anything about other
+ * buildings that another job of the same sweep changes.
+ */
+
+enum {
+    BUILDING_SWEEP_ALL = 0,
+    BUILDING_SWEEP_HOUSES = 1,
+    BUILDING_SWEEP_NON_HOUSES = 2
+};
+
+typedef struct {
+    /** Called before the pass, may be 0 */
+    void (*begin)(void);
+    /** Called for every valid building the job wants, in id order; 0 if the job has nothing to visit */
+    void (*visit)(building *b);
+    /** Called after the pass, may be 0 */
+    void (*end)(void);
+    /** Which buildings to visit: BUILDING_SWEEP_ALL, BUILDING_SWEEP_HOUSES or BUILDING_SWEEP_NON_HOUSES */
+    int buildings;
+} building_sweep_job;
+
+/**
+ * Runs the jobs: all begin callbacks in order, then one pass over the valid buildings calling
+ * the visitors of a building in job order, then all end callbacks in order
+ * @param jobs Jobs to run
+ * @param num_jobs Number of jobs
+ */
+void building_sweep_run(const building_sweep_job *jobs, int num_jobs);
+
+#endif // BUILDING_SWEEP_H
@@ -304,8 +304,8 @@ int building_warehouses_remove_resource(int resource, int amount) {
 int building_warehouse_for_storing(int src_building_id, int x, int y, int resource, int distance_from_entry, int road_network_id, int *understaffed, map_point *dst) {
     int min_dist = 10000;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_WAREHOUSE_SPACE); b; b = building_next_of_type(b)) {
+        int i = b->id;
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_WAREHOUSE_SPACE)
             continue;
 
@@ -351,8 +351,8 @@ int building_warehouse_for_storing(int src_building_id, int x, int y, int resour
 int building_warehouse_for_getting(building *src, int resource, map_point *dst) {
     int min_dist = 10000;
     building *min_building = 0;
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = building_next_of_type(b)) {
+        int i = b->id;
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_WAREHOUSE)
             continue;
 
@@ -398,8 +398,7 @@ static int determine_granary_accept_foods(int resources[8], int road_network) {
         resources[i] = 0;
     }
     int can_accept = 0;
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = building_next_of_type(b)) {
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_GRANARY || !b->has_road_access)
             continue;
 
@@ -429,8 +428,7 @@ static int determine_granary_get_foods(int resources[8], int road_network) {
         resources[i] = 0;
     }
     int can_get = 0;
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
+    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = building_next_of_type(b)) {
         if (b->state != BUILDING_STATE_VALID || b->type != BUILDING_GRANARY || !b->has_road_access)
             continue;
 
@@ -1,7 +1,9 @@
 #include "labor.h"
 
 #include "building/building.h"
+#include "building/count.h"
 #include "building/model.h"
+#include "building/sweep.h"
 #include "core/config.h"
 #include "city/data_private.h"
 #include "city/message.h"
@@ -225,21 +227,23 @@ static void calculate_workers_needed_per_category(void) {
         city_data.labor.categories[category].buildings++;
     }
 }
-static void set_building_worker_weight(void) {
-    int water_per_10k_per_building = calc_percentage(100, city_data.labor.categories[LABOR_CATEGORY_WATER_HEALTH].buildings);
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_VALID)
-            continue;
+static struct {
+    int water_per_10k_per_building;
+    int category_workers_needed[MAX_CATS];
+    int category_workers_allocated[MAX_CATS];
+} allocation;
 
-        int cat = CATEGORY_FOR_building(b);
-        if (cat == LABOR_CATEGORY_WATER_HEALTH)
-            b->percentage_houses_covered = water_per_10k_per_building;
-        else if (cat >= 0) {
-            b->percentage_houses_covered = 0;
-            if (b->houses_covered) {
-                b->percentage_houses_covered = calc_percentage(100 * b->houses_covered, city_data.labor.categories[cat].total_houses_covered);
-            }
+static void begin_worker_weight(void) {
+    allocation.water_per_10k_per_building = calc_percentage(100, city_data.labor.categories[LABOR_CATEGORY_WATER_HEALTH].buildings);
+}
+static void set_building_worker_weight(building *b) {
+    int cat = CATEGORY_FOR_building(b);
+    if (cat == LABOR_CATEGORY_WATER_HEALTH)
+        b->percentage_houses_covered = allocation.water_per_10k_per_building;
+    else if (cat >= 0) {
+        b->percentage_houses_covered = 0;
+        if (b->houses_covered) {
+            b->percentage_houses_covered = calc_percentage(100 * b->houses_covered, city_data.labor.categories[cat].total_houses_covered);
         }
     }
 }
@@ -353,59 +357,62 @@ static void allocate_workers_to_water(void) {
             } else
                 b->num_workers = model_get_building(b->type)->laborers;
         }
+        building_count_refresh(b);
     }
     if (!start_building_id) {
         // no buildings assigned or full employment
         start_building_id = 1;
     }
 }
-static void allocate_workers_to_non_water_buildings(void) {
-    int category_workers_needed[MAX_CATS];
-    int category_workers_allocated[MAX_CATS];
+static void begin_non_water_allocation(void) {
     for (int i = 0; i < MAX_CATS; i++) {
-        category_workers_allocated[i] = 0;
-        category_workers_needed[i] =
+        allocation.category_workers_allocated[i] = 0;
+        allocation.category_workers_needed[i] =
                 city_data.labor.categories[i].workers_allocated < city_data.labor.categories[i].workers_needed
                 ? 1 : 0;
     }
-    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_VALID)
-            continue;
-        int cat = CATEGORY_FOR_building(b);
-        if (GAME_ENV == ENGINE_ENV_C3 && cat == LABOR_CATEGORY_WATER_HEALTH)
-            continue;
-        if (cat == 255) {
-            if (b->data.industry.labor_state <= 0)
-                b->num_workers = 0;
-            continue; // water is handled by allocate_workers_to_water(void) in C3
-        }
-        b->num_workers = 0;
-        if (!should_have_workers(b, cat, 0))
-            continue;
-        if (b->percentage_houses_covered > 0) {
-            int required_workers = model_get_building(b->type)->laborers;
-            if (category_workers_needed[cat]) {
-                int num_workers = calc_adjust_with_percentage(
-                        city_data.labor.categories[cat].workers_allocated,
-                        b->percentage_houses_covered) / 100;
-                if (num_workers > required_workers)
-                    num_workers = required_workers;
-
-                b->num_workers = num_workers;
-                category_workers_allocated[cat] += num_workers;
-            } else
-                b->num_workers = required_workers;
+}
+static void allocate_workers_to_non_water_building(building *b) {
+    int cat = CATEGORY_FOR_building(b);
+    if (GAME_ENV == ENGINE_ENV_C3 && cat == LABOR_CATEGORY_WATER_HEALTH)
+        return;
+    if (cat == 255) {
+        if (b->data.industry.labor_state <= 0) {
+            b->num_workers = 0;
+            building_count_refresh(b);
         }
+        return; // water is handled by allocate_workers_to_water(void) in C3
     }
+    b->num_workers = 0;
+    if (!should_have_workers(b, cat, 0)) {
+        building_count_refresh(b);
+        return;
+    }
+    if (b->percentage_houses_covered > 0) {
+        int required_workers = model_get_building(b->type)->laborers;
+        if (allocation.category_workers_needed[cat]) {
+            int num_workers = calc_adjust_with_percentage(
+                    city_data.labor.categories[cat].workers_allocated,
+                    b->percentage_houses_covered) / 100;
+            if (num_workers > required_workers)
+                num_workers = required_workers;
+
+            b->num_workers = num_workers;
+            allocation.category_workers_allocated[cat] += num_workers;
+        } else
+            b->num_workers = required_workers;
+    }
+    building_count_refresh(b);
+}
+static void allocate_remaining_workers_to_non_water_buildings(void) {
     for (int i = 0; i < MAX_CATS; i++) {
-        if (category_workers_needed[i]) {
+        if (allocation.category_workers_needed[i]) {
             // watch out: category_workers_needed is now reset to 'unallocated workers available'
-            if (category_workers_allocated[i] >= city_data.labor.categories[i].workers_allocated) {
-                category_workers_needed[i] = 0;
-                category_workers_allocated[i] = 0;
+            if (allocation.category_workers_allocated[i] >= city_data.labor.categories[i].workers_allocated) {
+                allocation.category_workers_needed[i] = 0;
+                allocation.category_workers_allocated[i] = 0;
             } else
-                category_workers_needed[i] = city_data.labor.categories[i].workers_allocated - category_workers_allocated[i];
+                allocation.category_workers_needed[i] = city_data.labor.categories[i].workers_allocated - allocation.category_workers_allocated[i];
         }
     }
     for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
@@ -420,25 +427,32 @@ static void allocate_workers_to_non_water_buildings(void) {
                 continue;
         if (!should_have_workers(b, cat, 0))
             continue;
-        if (b->percentage_houses_covered > 0 && category_workers_needed[cat]) {
+        if (b->percentage_houses_covered > 0 && allocation.category_workers_needed[cat]) {
             int required_workers = model_get_building(b->type)->laborers;
             if (b->num_workers < required_workers) {
                 int needed = required_workers - b->num_workers;
-                if (needed > category_workers_needed[cat]) {
-                    b->num_workers += category_workers_needed[cat];
-                    category_workers_needed[cat] = 0;
+                if (needed > allocation.category_workers_needed[cat]) {
+                    b->num_workers += allocation.category_workers_needed[cat];
+                    allocation.category_workers_needed[cat] = 0;
                 } else {
                     b->num_workers += needed;
-                    category_workers_needed[cat] -= needed;
+                    allocation.category_workers_needed[cat] -= needed;
                 }
+                building_count_refresh(b);
             }
         }
     }
 }
 static void allocate_workers_to_buildings(void) {
-    set_building_worker_weight();
+    // the water allocation only touches water buildings, which the first non-water pass skips
+    // when there is a water allocation, so weighting and that pass can share one sweep
+    building_sweep_job jobs[] = {
+            {begin_worker_weight, set_building_worker_weight, 0, BUILDING_SWEEP_ALL},
+            {begin_non_water_allocation, allocate_workers_to_non_water_building, 0, BUILDING_SWEEP_ALL}
+    };
+    building_sweep_run(jobs, 2);
     allocate_workers_to_water();
-    allocate_workers_to_non_water_buildings();
+    allocate_remaining_workers_to_non_water_buildings();
 }
 
 static void check_employment(void) {
@@ -29,6 +29,8 @@ static view_data data;
 
 static int view_tile_to_grid_offset_lookup[500][500];
 static pixel_coordinate tile_xy_to_pixel_coord_lookup[500][500];
+static view_tile grid_offset_to_view_tile_lookup[GRID_SIZE_PH * GRID_SIZE_PH];
+static int lookup_version;
 
 view_data *city_view_data_unsafe() {
     return &data;
@@ -206,12 +208,14 @@ static void calculate_lookup(void) {
                 view_tile_to_grid_offset_lookup[x_view / 2][y_view] = grid_offset;
             else // outside area
                 view_tile_to_grid_offset_lookup[x_view / 2][y_view] = -1;
+            grid_offset_to_view_tile_lookup[grid_offset] = view_tile {x_view / 2, y_view};
             x_view += x_view_step;
             y_view += y_view_step;
         }
         x_view_start += x_view_skip;
         y_view_start += y_view_skip;
     }
+    lookup_version++;
 }
 
 //static void adjust_camera_position_for_pixels(void) {
@@ -555,6 +559,61 @@ void city_view_foreach_map_tile(map_callback *callback) {
         y_view++;
     }
 }
+void city_view_foreach_map_tile_in_band(int y_min, int y_max, map_callback *callback) {
+    int odd = 0;
+    int y_view = data.camera.tile_internal.y - 8;
+    int y_graphic = data.viewport.y - 9 * HALF_TILE_HEIGHT_PIXELS - data.camera.pixel_offset_internal.y;
+    for (int y = 0; y < data.viewport.height_tiles + 21 && y_graphic <= y_max; y++) {
+        if (y_graphic >= y_min && y_view >= 0 && y_view < MAP_TILE_UPPER_LIMIT_Y()) {
+            int x_graphic = -(4 * TILE_WIDTH_PIXELS) - data.camera.pixel_offset_internal.x;
+            if (odd)
+                x_graphic += data.viewport.x - HALF_TILE_WIDTH_PIXELS;
+            else
+                x_graphic += data.viewport.x;
+            int x_view = data.camera.tile_internal.x - 4;
+            for (int x = 0; x < data.viewport.width_tiles + 7; x++) {
+                if (x_view >= 0 && x_view < MAP_TILE_UPPER_LIMIT_X())
+                    callback(x_graphic, y_graphic, view_tile_to_grid_offset_lookup[x_view][y_view]);
+                x_graphic += TILE_WIDTH_PIXELS;
+                x_view++;
+            }
+        }
+        odd = 1 - odd;
+        y_graphic += HALF_TILE_HEIGHT_PIXELS;
+        y_view++;
+    }
+}
+int city_view_lookup_version(void) {
+    return lookup_version;
+}
+void city_view_grid_offset_to_map_pixels(int grid_offset, int *x, int *y) {
+    const view_tile *tile = &grid_offset_to_view_tile_lookup[grid_offset];
+    *x = tile->x * TILE_WIDTH_PIXELS - (tile->y & 1) * HALF_TILE_WIDTH_PIXELS;
+    *y = tile->y * HALF_TILE_HEIGHT_PIXELS;
+}
+void city_view_get_map_pixel_origin(int *x, int *y) {
+    // same arithmetic as the foreach functions, so both agree on every pixel
+    *x = data.viewport.x - data.camera.tile_internal.x * TILE_WIDTH_PIXELS - data.camera.pixel_offset_internal.x;
+    *y = data.viewport.y - HALF_TILE_HEIGHT_PIXELS - data.camera.tile_internal.y * HALF_TILE_HEIGHT_PIXELS
+            - data.camera.pixel_offset_internal.y;
+}
+void city_view_foreach_tile_in_map_pixels(int x_min, int y_min, int x_max, int y_max, map_callback *callback) {
+    int y_view_min = y_min > 0 ? y_min / HALF_TILE_HEIGHT_PIXELS : 0;
+    int y_view_max = y_max / HALF_TILE_HEIGHT_PIXELS;
+    if (y_view_max >= MAP_TILE_UPPER_LIMIT_Y())
+        y_view_max = MAP_TILE_UPPER_LIMIT_Y() - 1;
+    for (int y_view = y_view_min; y_view <= y_view_max; y_view++) {
+        int odd_offset = (y_view & 1) * HALF_TILE_WIDTH_PIXELS;
+        int x_view_min = x_min + odd_offset > 0 ? (x_min + odd_offset) / TILE_WIDTH_PIXELS : 0;
+        int x_view_max = (x_max + odd_offset) / TILE_WIDTH_PIXELS;
+        if (x_view_max >= MAP_TILE_UPPER_LIMIT_X())
+            x_view_max = MAP_TILE_UPPER_LIMIT_X() - 1;
+        for (int x_view = x_view_min; x_view <= x_view_max; x_view++) {
+            callback(x_view * TILE_WIDTH_PIXELS - odd_offset, y_view * HALF_TILE_HEIGHT_PIXELS,
+                     view_tile_to_grid_offset_lookup[x_view][y_view]);
+        }
+    }
+}
 void city_view_foreach_valid_map_tile(map_callback *callback1, map_callback *callback2, map_callback *callback3) {
     int odd = 0;
     int y_view = data.camera.tile_internal.y - 8;
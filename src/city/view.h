@@ -95,6 +95,30 @@ void city_view_save_scenario_state(buffer *camera);
 void city_view_load_scenario_state(buffer *camera);
 
 void city_view_foreach_map_tile(map_callback *callback);
+/**
+ * Same as city_view_foreach_map_tile, limited to the tile rows drawn between y_min and y_max.
+ * Does not update the pixel coordinate lookup, so it can run on several threads at once.
+ */
+void city_view_foreach_map_tile_in_band(int y_min, int y_max, map_callback *callback);
+
+/**
+ * Gets a number that changes whenever the view tiles are mapped to grid offsets anew
+ */
+int city_view_lookup_version(void);
+/**
+ * Gets where a tile is drawn in map pixels, which do not depend on the camera position:
+ * the view tile x_view, y_view is drawn at x_view * 60 (30 less on odd rows), y_view * 15
+ */
+void city_view_grid_offset_to_map_pixels(int grid_offset, int *x, int *y);
+/**
+ * Gets the screen position of map pixel 0, 0 for the current camera position
+ */
+void city_view_get_map_pixel_origin(int *x, int *y);
+/**
+ * Calls the callback with the map pixel position of every view tile drawn between x_min, y_min and x_max, y_max.
+ * Does not update the pixel coordinate lookup, so it can run on several threads at once.
+ */
+void city_view_foreach_tile_in_map_pixels(int x_min, int y_min, int x_max, int y_max, map_callback *callback);
 void city_view_foreach_valid_map_tile(map_callback *callback1, map_callback *callback2, map_callback *callback3);
 void city_view_foreach_tile_in_range(int grid_offset, int size, int radius, map_callback *callback);
 void city_view_foreach_minimap_tile(int x_offset, int y_offset, int absolute_x, int absolute_y, int width_tiles,
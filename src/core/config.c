@@ -49,7 +49,11 @@ static const char *ini_keys[] = {
         "gameplay_change_multiple_barracks",
         "gameplay_change_warehouses_dont_accept",
         "gameplay_change_houses_dont_expand_into_gardens",
-
+        "gameplay_change_astar_routing",
+        "gameplay_change_incremental_desirability",
+        "gameplay_change_incremental_building_counts",
+        "ui_scroll_keepdelta",
+        "ui_lazy_image_budget_mb",
 };
 
 static const char *ini_string_keys[] = {
@@ -96,6 +100,16 @@ static char string_values[CONFIG_STRING_MAX_ENTRIES][CONFIG_STRING_VALUE_MAX];
 #define CONFIG_DEFAULT_GP_CH_MULTIPLE_BARRACKS 0
 #define CONFIG_DEFAULT_GP_CH_WAREHOUSES_DONT_ACCEPT 0
 #define CONFIG_DEFAULT_GP_CH_HOUSES_DONT_EXPAND_INTO_GARDENS 0
+#define CONFIG_DEFAULT_GP_CH_ASTAR_ROUTING 0
+#define CONFIG_DEFAULT_GP_CH_INCREMENTAL_DESIRABILITY 0
+#define CONFIG_DEFAULT_GP_CH_INCREMENTAL_BUILDING_COUNTS 0
+#define CONFIG_DEFAULT_UI_SCROOL_KEEPDELTA 0
+// megabytes of decoded images to keep when images are decoded on first use, 0 decodes everything on load
+#if defined(__vita__) || defined(__SWITCH__)
+#define CONFIG_DEFAULT_UI_LAZY_IMAGE_BUDGET 48
+#else
+#define CONFIG_DEFAULT_UI_LAZY_IMAGE_BUDGET 0
+#endif
 
 static int default_values[CONFIG_MAX_ENTRIES] = {
         CONFIG_DEFAULT_GP_FIX_IMMIGRATION_BUG,
@@ -134,7 +148,12 @@ static int default_values[CONFIG_MAX_ENTRIES] = {
         CONFIG_DEFAULT_GP_CH_RANDOM_COLLAPSES_TAKE_MONEY,
         CONFIG_DEFAULT_GP_CH_MULTIPLE_BARRACKS,
         CONFIG_DEFAULT_GP_CH_WAREHOUSES_DONT_ACCEPT,
-        CONFIG_DEFAULT_GP_CH_HOUSES_DONT_EXPAND_INTO_GARDENS
+        CONFIG_DEFAULT_GP_CH_HOUSES_DONT_EXPAND_INTO_GARDENS,
+        CONFIG_DEFAULT_GP_CH_ASTAR_ROUTING,
+        CONFIG_DEFAULT_GP_CH_INCREMENTAL_DESIRABILITY,
+        CONFIG_DEFAULT_GP_CH_INCREMENTAL_BUILDING_COUNTS,
+        CONFIG_DEFAULT_UI_SCROOL_KEEPDELTA,
+        CONFIG_DEFAULT_UI_LAZY_IMAGE_BUDGET
 };
 
 static char default_string_values[CONFIG_STRING_MAX_ENTRIES][CONFIG_STRING_VALUE_MAX];
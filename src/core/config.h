@@ -41,7 +41,11 @@ enum {
     CONFIG_GP_CH_MULTIPLE_BARRACKS,
     CONFIG_GP_CH_WAREHOUSES_DONT_ACCEPT,
     CONFIG_GP_CH_HOUSES_DONT_EXPAND_INTO_GARDENS,
+    CONFIG_GP_CH_ASTAR_ROUTING,
+    CONFIG_GP_CH_INCREMENTAL_DESIRABILITY,
+    CONFIG_GP_CH_INCREMENTAL_BUILDING_COUNTS,
     CONFIG_UI_SCROOL_KEEPDELTA,
+    CONFIG_UI_LAZY_IMAGE_BUDGET,
     CONFIG_MAX_ENTRIES
 };
 
@@ -76,3 +76,19 @@ int file_exists(const char *filename, int localizable) {
 int file_remove(const char *filename) {
     return platform_file_manager_remove_file(filename);
 }
+
+int file_rename(const char *from, const char *to) {
+    return platform_file_manager_rename_file(from, to);
+}
+
+int file_get_info(const char *filename, int64_t *size, int64_t *modified_time) {
+    return platform_file_manager_get_file_info(filename, size, modified_time);
+}
+
+const void *file_map(const char *filename, size_t *size) {
+    return platform_file_manager_map_file(filename, size);
+}
+
+void file_unmap(const void *data, size_t size) {
+    platform_file_manager_unmap_file(data, size);
+}
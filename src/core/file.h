@@ -77,4 +77,36 @@ int file_exists(const char *filename, int localizable);
  */
 int file_remove(const char *filename);
 
+/**
+ * Rename a file, replacing the destination if it exists
+ * @param from Filename to rename
+ * @param to New filename
+ * @return boolean true if renaming was successful, false otherwise
+ */
+int file_rename(const char *from, const char *to);
+
+/**
+ * Get the size and modification time of a file
+ * @param filename Filename to check
+ * @param size Filled with the size in bytes
+ * @param modified_time Filled with the modification time
+ * @return boolean true if the file exists, false otherwise
+ */
+int file_get_info(const char *filename, int64_t *size, int64_t *modified_time);
+
+/**
+ * Map a file read-only into memory
+ * @param filename Filename to map
+ * @param size Filled with the size of the mapping
+ * @return Contents of the file, or NULL if it could not be mapped
+ */
+const void *file_map(const char *filename, size_t *size);
+
+/**
+ * Unmap a file mapped with file_map
+ * @param data Contents of the file
+ * @param size Size of the mapping
+ */
+void file_unmap(const void *data, size_t size);
+
 #endif // CORE_FILE_H
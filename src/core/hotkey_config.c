@@ -80,6 +80,8 @@ static const char *ini_keys[] = {
         "resize_to_1024",
         "save_screenshot",
         "save_city_screenshot",
+        "toggle_profiler",
+        "dump_profiler",
 };
 
 static struct {
@@ -176,6 +178,8 @@ void init_defaults(void) {
     set_mapping(KEY_F12, KEY_MOD_NONE, HOTKEY_SAVE_SCREENSHOT);
     set_mapping(KEY_F12, KEY_MOD_ALT, HOTKEY_SAVE_SCREENSHOT); // mac specific
     set_mapping(KEY_F12, KEY_MOD_CTRL, HOTKEY_SAVE_CITY_SCREENSHOT);
+    set_mapping(KEY_F11, KEY_MOD_NONE, HOTKEY_TOGGLE_PROFILER);
+    set_mapping(KEY_F11, KEY_MOD_CTRL, HOTKEY_DUMP_PROFILER);
 }
 
 const hotkey_mapping *hotkey_for_action(int action, int index) {
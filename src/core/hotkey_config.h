@@ -69,6 +69,8 @@ enum {
     HOTKEY_RESIZE_TO_1024,
     HOTKEY_SAVE_SCREENSHOT,
     HOTKEY_SAVE_CITY_SCREENSHOT,
+    HOTKEY_TOGGLE_PROFILER,
+    HOTKEY_DUMP_PROFILER,
     HOTKEY_MAX_ITEMS
 };
 
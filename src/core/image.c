@@ -10,15 +10,77 @@
 #include "core/config.h"
 #include "core/game_environment.h"
 #include "core/table_translation.h"
+#include "core/thread_pool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 
 #define ENTRY_SIZE 64
 #define NAME_SIZE 32
 
 #define SCRATCH_DATA_SIZE 20000000
 
+// bytes of 555 data converted by one loading job
+#define CONVERSION_JOB_SIZE 1000000
+
+// the converted pixels of a pak are cached on disk and mapped back in on the next load
+#if defined(__vita__) || defined(__SWITCH__)
+#define HAS_IMAGE_CACHE 0
+#else
+#define HAS_IMAGE_CACHE 1
+#endif
+
+#define IMAGE_CACHE_MAGIC 0x43474d49 // "IMGC"
+#define IMAGE_CACHE_VERSION 1
+
+enum {
+    SOURCE_SGX_SIZE = 0,
+    SOURCE_SGX_MODIFIED = 1,
+    SOURCE_555_SIZE = 2,
+    SOURCE_555_MODIFIED = 3,
+    SOURCE_INFO_SIZE = 4
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t image_size;
+    int32_t entries_num;
+    int32_t groups_num;
+    int32_t num_pixels;
+    int64_t source_info[SOURCE_INFO_SIZE];
+    uint32_t header_data[10];
+    uint16_t group_image_ids[300];
+} image_cache_header;
+
+// a pak that is being loaded
+struct pak_load {
+    imagepak *pak;
+    const char *filename_555;
+    const char *filename_sgx;
+    int shift;
+    int result;
+    char cased_555[FILE_NAME_MAX];
+    char cased_sgx[FILE_NAME_MAX];
+    int use_cache;
+    int64_t source_info[SOURCE_INFO_SIZE];
+    char cache_path[FILE_NAME_MAX + 6]; // cased_sgx plus ".cache"
+    int needs_conversion;
+    buffer *data_555;
+    int *file_offsets;
+    int num_pixels;
+};
+
+typedef struct {
+    pak_load *load;
+    int first_image;
+    int last_image;
+} conversion_job;
+
 enum {
     NO_EXTRA_FONT = 0,
     FULL_CHARSET_IN_FONT = 1,
@@ -241,6 +303,24 @@ static struct {
         new color_t[SCRATCH_DATA_SIZE - 4000000]
 };
 
+// pixels of paks that are decoded on first use, one block per image group
+struct image_block {
+    std::atomic<color_t *> data;
+    std::atomic<unsigned int> last_used_frame;
+    int first_image;
+    int num_images;
+    int file_offset;
+    int file_length;
+    int num_pixels;
+};
+
+static struct {
+    std::mutex mutex;
+    size_t decoded_bytes;
+    unsigned int frame;
+    std::vector<image_block *> decoded_blocks;
+} lazy;
+
 int terrain_ph_offset = 0;
 
 //void mem_test_leak(int j = 100) {
@@ -258,29 +338,72 @@ static color_t to_32_bit(uint16_t c) {
            ((c & 0x1f) << 3) | ((c & 0x1c) >> 2);
 }
 
-static int convert_uncompressed(buffer *buf, int amount, color_t *dst) {
+// reads 555 data like buffer does, returning zeros past the end, but can be used by several threads at once
+typedef struct {
+    const uint8_t *data;
+    int size;
+    int index;
+} pixel_reader;
+
+static pixel_reader reader_at(const buffer *buf, int offset) {
+    pixel_reader reader = {buf->get_data(), (int) buf->size(), offset};
+    return reader;
+}
+static uint8_t read_u8(pixel_reader *reader) {
+    if (reader->index < 0 || reader->index + 1 > reader->size)
+        return 0;
+    return reader->data[reader->index++];
+}
+static uint16_t read_u16(pixel_reader *reader) {
+    if (reader->index < 0 || reader->index + 2 > reader->size)
+        return 0;
+    uint16_t result = (uint16_t) (reader->data[reader->index] | (reader->data[reader->index + 1] << 8));
+    reader->index += 2;
+    return result;
+}
+
+static int convert_uncompressed(pixel_reader *src, int amount, color_t *dst) {
     for (int i = 0; i < amount; i += 2) {
-        color_t c = to_32_bit(buf->read_u16());
+        color_t c = to_32_bit(read_u16(src));
         *dst = c;
         dst++;
     }
     return amount / 2;
 }
-static int convert_compressed(buffer *buf, int amount, color_t *dst) {
+static int convert_compressed(pixel_reader *src, int amount, color_t *dst) {
     int dst_length = 0;
     while (amount > 0) {
-        int control = buf->read_u8();
+        int control = read_u8(src);
         if (control == 255) {
             // next byte = transparent pixels to skip
             *dst++ = 255;
-            *dst++ = buf->read_u8();
+            *dst++ = read_u8(src);
             dst_length += 2;
             amount -= 2;
         } else {
             // control = number of concrete pixels
             *dst++ = control;
             for (int i = 0; i < control; i++) {
-                *dst++ = to_32_bit(buf->read_u16());
+                *dst++ = to_32_bit(read_u16(src));
+            }
+            dst_length += control + 1;
+            amount -= control * 2 + 1;
+        }
+    }
+    return dst_length;
+}
+// number of pixels convert_compressed produces, without converting
+static int compressed_length(pixel_reader *src, int amount) {
+    int dst_length = 0;
+    while (amount > 0) {
+        int control = read_u8(src);
+        if (control == 255) {
+            read_u8(src);
+            dst_length += 2;
+            amount -= 2;
+        } else {
+            for (int i = 0; i < control; i++) {
+                read_u16(src);
             }
             dst_length += control + 1;
             amount -= control * 2 + 1;
@@ -326,11 +449,13 @@ static const color_t *load_external_data(const image *img) {
 //    color_t *dst = (color_t *) &data.tmp_data[4000000];
 
     // NB: isometric images are never external
+    pixel_reader reader = reader_at(buf, 0);
     if (img->draw.is_fully_compressed)
-        convert_compressed(buf, img->draw.data_length, data.tmp_image_data);
+        convert_compressed(&reader, img->draw.data_length, data.tmp_image_data);
     else {
-        convert_uncompressed(buf, img->draw.data_length, data.tmp_image_data);
+        convert_uncompressed(&reader, img->draw.data_length, data.tmp_image_data);
     }
+    delete buf;
     return data.tmp_image_data;
 }
 
@@ -340,20 +465,263 @@ imagepak::imagepak() {
     initialized = false;
     images = nullptr;
     data = nullptr;
+    cache_mapping = nullptr;
+    cache_mapping_size = 0;
+    blocks = nullptr;
+    num_blocks = 0;
+    image_block_ids = nullptr;
+    lazy_filename_555 = nullptr;
     entries_num = 0;
     group_image_ids = new uint16_t[300];
 }
-bool imagepak::check_initialized() {
-    return initialized == 0;
+void imagepak::release() {
+    if (!initialized)
+        return;
+    initialized = false;
+    delete[] images;
+    if (cache_mapping) {
+        file_unmap(cache_mapping, cache_mapping_size);
+        cache_mapping = nullptr;
+    } else
+        delete[] data;
+    images = nullptr;
+    data = nullptr;
+    if (blocks) {
+        std::lock_guard<std::mutex> lock(lazy.mutex);
+        for (int i = 0; i < num_blocks; i++) {
+            color_t *pixels = blocks[i].data.load();
+            if (pixels) {
+                lazy.decoded_bytes -= sizeof(color_t) * blocks[i].num_pixels;
+                delete[] pixels;
+            }
+        }
+        delete[] blocks;
+        delete[] image_block_ids;
+        delete[] lazy_filename_555;
+        blocks = nullptr;
+        num_blocks = 0;
+        image_block_ids = nullptr;
+        lazy_filename_555 = nullptr;
+    }
 }
-int imagepak::load_555(const char *filename_555, const char *filename_sgx, int shift) {
+void imagepak::prepare_lazy_blocks(const char *filename_555) {
+    lazy_filename_555 = new char[strlen(filename_555) + 1];
+    strcpy(lazy_filename_555, filename_555);
+
+    // every group starts a new block
+    image_block_ids = new int[entries_num];
+    memset(image_block_ids, 0, sizeof(int) * entries_num);
+    image_block_ids[0] = 1;
+    for (int i = 0; i < 300; i++) {
+        if (group_image_ids[i] < entries_num)
+            image_block_ids[group_image_ids[i]] = 1;
+    }
+    num_blocks = 0;
+    for (int i = 0; i < entries_num; i++) {
+        if (image_block_ids[i])
+            num_blocks++;
+    }
+    blocks = new image_block[num_blocks];
+    int block_id = -1;
+    for (int i = 0; i < entries_num; i++) {
+        if (image_block_ids[i]) {
+            block_id++;
+            image_block *block = &blocks[block_id];
+            block->data = nullptr;
+            block->last_used_frame = 0;
+            block->first_image = i;
+            block->num_images = 0;
+            block->file_offset = -1;
+            block->file_length = 0;
+            block->num_pixels = 1; // make sure img->offset > 0
+        }
+        image_block_ids[i] = block_id;
+        image_block *block = &blocks[block_id];
+        block->num_images++;
+
+        // non-external images of a block are stored back to back in the 555 file
+        image *img = &images[i];
+        if (img->draw.is_external)
+            continue;
+        if (block->file_offset < 0 && img->draw.data_length > 0)
+            block->file_offset = img->draw.offset;
+        block->file_length += img->draw.data_length;
+
+        // reserve the most pixels the image can decode to
+        int max_pixels;
+        if (img->draw.is_fully_compressed)
+            max_pixels = img->draw.data_length;
+        else if (img->draw.has_compressed_part)
+            max_pixels = img->draw.uncompressed_length / 2 + img->draw.data_length - img->draw.uncompressed_length;
+        else
+            max_pixels = img->draw.data_length / 2;
+        img->draw.offset = block->num_pixels;
+        img->draw.uncompressed_length /= 2;
+        img->draw.data = nullptr;
+        block->num_pixels += max_pixels;
+    }
+}
+const color_t *imagepak::decode_block(image_block *block) {
+    color_t *pixels = new color_t[block->num_pixels]();
+    if (block->file_length > 0) {
+        buffer buf(block->file_length);
+        FILE *fp = file_open(lazy_filename_555, "rb");
+        int ok = fp && fseek(fp, block->file_offset, SEEK_SET) == 0 &&
+                 buf.from_file(block->file_length, fp) == (size_t) block->file_length;
+        if (fp)
+            file_close(fp);
+        if (!ok)
+            log_error("unable to load images from", lazy_filename_555, block->first_image);
+        pixel_reader reader = reader_at(&buf, 0);
+        for (int i = block->first_image; ok && i < block->first_image + block->num_images; i++) {
+            image *img = &images[i];
+            if (img->draw.is_external)
+                continue;
+            color_t *dst = &pixels[img->draw.offset];
+            if (img->draw.is_fully_compressed)
+                convert_compressed(&reader, img->draw.data_length, dst);
+            else if (img->draw.has_compressed_part) { // isometric tile
+                int uncompressed_length = img->draw.uncompressed_length * 2;
+                dst += convert_uncompressed(&reader, uncompressed_length, dst);
+                convert_compressed(&reader, img->draw.data_length - uncompressed_length, dst);
+            } else
+                convert_uncompressed(&reader, img->draw.data_length, dst);
+        }
+    }
+    lazy.decoded_bytes += sizeof(color_t) * block->num_pixels;
+    block->data.store(pixels, std::memory_order_release);
+    return pixels;
+}
+bool imagepak::load_cache(const char *cache_path, const int64_t *source_info) {
+    size_t size;
+    const void *mapping = file_map(cache_path, &size);
+    if (!mapping)
+        return false;
+    const image_cache_header *header = (const image_cache_header *) mapping;
+    if (size < sizeof(image_cache_header) || header->magic != IMAGE_CACHE_MAGIC ||
+        header->version != IMAGE_CACHE_VERSION || header->image_size != sizeof(image) ||
+        memcmp(header->source_info, source_info, sizeof(header->source_info)) != 0 ||
+        header->entries_num <= 0 || header->num_pixels <= 0 ||
+        size != sizeof(image_cache_header) + sizeof(image) * header->entries_num +
+                sizeof(color_t) * header->num_pixels) {
+        file_unmap(mapping, size);
+        return false;
+    }
+    const char *contents = (const char *) mapping;
+    entries_num = header->entries_num;
+    groups_num = header->groups_num;
+    memcpy(header_data, header->header_data, sizeof(header_data));
+    memcpy(group_image_ids, header->group_image_ids, sizeof(header->group_image_ids));
+
+    // the pixels stay in the read-only mapping, only the metadata is copied to fix up the pointers
+    data = (color_t *) (contents + sizeof(image_cache_header) + sizeof(image) * entries_num);
+    images = new image[entries_num];
+    memcpy(images, contents + sizeof(image_cache_header), sizeof(image) * entries_num);
+    for (int i = 0; i < entries_num; i++) {
+        image *img = &images[i];
+        img->draw.data = img->draw.is_external ? nullptr : &data[img->draw.offset];
+    }
+    cache_mapping = mapping;
+    cache_mapping_size = size;
+    initialized = true;
+    return true;
+}
+void imagepak::save_cache(const char *cache_path, const int64_t *source_info, int num_pixels) {
+    image_cache_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = IMAGE_CACHE_MAGIC;
+    header.version = IMAGE_CACHE_VERSION;
+    header.image_size = sizeof(image);
+    header.entries_num = entries_num;
+    header.groups_num = groups_num;
+    header.num_pixels = num_pixels;
+    memcpy(header.source_info, source_info, sizeof(header.source_info));
+    memcpy(header.header_data, header_data, sizeof(header.header_data));
+    memcpy(header.group_image_ids, group_image_ids, sizeof(header.group_image_ids));
+
+    // write to a temporary file first so an interrupted write never leaves a broken cache behind
+    char temp_path[FILE_NAME_MAX + 10];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", cache_path) >= (int) sizeof(temp_path)) {
+        log_info("Image cache path too long", cache_path, 0);
+        return;
+    }
+    FILE *fp = file_open(temp_path, "wb");
+    if (!fp) {
+        log_info("Unable to write image cache", cache_path, 0);
+        return;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (int i = 0; i < entries_num && ok; i++) {
+        image img = images[i];
+        img.draw.data = nullptr;
+        ok = fwrite(&img, sizeof(image), 1, fp) == 1;
+    }
+    if (ok)
+        ok = fwrite(data, sizeof(color_t), num_pixels, fp) == (size_t) num_pixels;
+    if (file_close(fp) != 0)
+        ok = 0;
+    if (!ok || !file_rename(temp_path, cache_path)) {
+        log_info("Unable to write image cache", cache_path, 0);
+        file_remove(temp_path);
+    }
+}
+static buffer *read_file(const char *filename) {
+    FILE *fp = file_open(filename, "rb");
+    if (!fp)
+        return nullptr;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buffer *buf = new buffer((size_t) size);
+    size_t bytes_read = buf->from_file((size_t) size, fp);
+    file_close(fp);
+    if (!bytes_read) {
+        delete buf;
+        return nullptr;
+    }
+    return buf;
+}
+int imagepak::start_load(pak_load *load) {
+    id_shift_overall = load->shift;
+    name = load->filename_sgx;
+    release();
+    load->needs_conversion = 0;
+    load->data_555 = nullptr;
+    load->file_offsets = nullptr;
+
+    // file names are looked up here because dir_get_file may only be used by one thread
+    const char *cased_file = dir_get_file(load->filename_sgx, MAY_BE_LOCALIZED);
+    if (!cased_file)
+        return 0;
+    strncpy(load->cased_sgx, cased_file, FILE_NAME_MAX - 1);
+    load->cased_sgx[FILE_NAME_MAX - 1] = 0;
+    cased_file = dir_get_file(load->filename_555, MAY_BE_LOCALIZED);
+    if (!cased_file)
+        return 0;
+    strncpy(load->cased_555, cased_file, FILE_NAME_MAX - 1);
+    load->cased_555[FILE_NAME_MAX - 1] = 0;
+
+    load->use_cache = HAS_IMAGE_CACHE &&
+                      file_get_info(load->cased_sgx, &load->source_info[SOURCE_SGX_SIZE],
+                                    &load->source_info[SOURCE_SGX_MODIFIED]) &&
+                      file_get_info(load->cased_555, &load->source_info[SOURCE_555_SIZE],
+                                    &load->source_info[SOURCE_555_MODIFIED]);
+    if (load->use_cache)
+        snprintf(load->cache_path, sizeof(load->cache_path), "%s.cache", load->cased_sgx);
+    return 1;
+}
+int imagepak::read_files(pak_load *load) {
+    if (load->use_cache && load_cache(load->cache_path, load->source_info))
+        return 1;
+
+    int is_lazy = config_get(CONFIG_UI_LAZY_IMAGE_BUDGET) > 0;
+
     // prepare sgx data
-    buffer *buf = new buffer(SCRATCH_DATA_SIZE);
-    if (!io_read_file_into_buffer(filename_sgx, MAY_BE_LOCALIZED, buf,
-                                  SCRATCH_DATA_SIZE)) //int MAIN_INDEX_SIZE = 660680;
+    buffer *buf = read_file(load->cased_sgx);
+    if (!buf)
         return 0;
     int HEADER_SIZE = 0;
-    if (file_has_extension(filename_sgx, "sg2"))
+    if (file_has_extension(load->filename_sgx, "sg2"))
         HEADER_SIZE = 20680; // sg2 has 100 bitmap entries
     else
         HEADER_SIZE = 40680; //
@@ -363,15 +731,7 @@ int imagepak::load_555(const char *filename_555, const char *filename_sgx, int s
 
     // allocate arrays
     entries_num = (size_t) header_data[4] + 1;
-    id_shift_overall = shift;
-    name = filename_sgx;
-    if (check_initialized()) {
-        initialized = false;
-        delete images;
-        delete data;
-    }
     images = new image[entries_num];
-    data = new color_t[entries_num * 10000];
     initialized = true;
 
     buf->skip(40); // skip remaining 40 bytes
@@ -399,6 +759,7 @@ int imagepak::load_555(const char *filename_555, const char *filename_sgx, int s
     int bmp_lastindex = 1;
     for (int i = 0; i < entries_num; i++) {
         image img;
+        memset(&img, 0, sizeof(image));
         img.draw.offset = buf->read_i32();
         img.draw.data_length = buf->read_i32();
         img.draw.uncompressed_length = buf->read_i32();
@@ -451,38 +812,136 @@ int imagepak::load_555(const char *filename_555, const char *filename_sgx, int s
         }
     }
 
+    delete buf;
+
+    // leave the pixels in the 555 file until they are drawn
+    if (is_lazy) {
+        prepare_lazy_blocks(load->cased_555);
+        return 1;
+    }
+
     // prepare bitmap data
-    buf->clear();
-    int data_size = io_read_file_into_buffer(filename_555, MAY_BE_LOCALIZED, buf, SCRATCH_DATA_SIZE);
-    if (!data_size)
+    load->data_555 = read_file(load->cased_555);
+    if (!load->data_555)
         return 0;
 
-    // convert bitmap data for image pool
-    color_t *start_dst = data;
-    color_t *dst = data;
-    dst++; // make sure img->offset > 0
+    // lay out the image pool, so the images can be converted in any order
+    load->file_offsets = new int[entries_num];
+    int num_pixels = 1; // make sure img->offset > 0
     for (int i = 0; i < entries_num; i++) {
         image *img = &images[i];
         if (img->draw.is_external)
             continue;
-        buf->set_offset(img->draw.offset);
-        int img_offset = (int) (dst - start_dst);
-
+        load->file_offsets[i] = img->draw.offset;
+        int img_offset = num_pixels;
+        if (img->draw.is_fully_compressed) {
+            pixel_reader reader = reader_at(load->data_555, img->draw.offset);
+            num_pixels += compressed_length(&reader, img->draw.data_length);
+        } else if (img->draw.has_compressed_part) { // isometric tile
+            pixel_reader reader = reader_at(load->data_555, img->draw.offset + img->draw.uncompressed_length);
+            num_pixels += img->draw.uncompressed_length / 2;
+            num_pixels += compressed_length(&reader, img->draw.data_length - img->draw.uncompressed_length);
+        } else
+            num_pixels += img->draw.data_length / 2;
+        img->draw.offset = img_offset;
+    }
+    data = new color_t[num_pixels];
+    data[0] = 0;
+    for (int i = 0; i < entries_num; i++) {
+        image *img = &images[i];
+        if (!img->draw.is_external)
+            img->draw.data = &data[img->draw.offset];
+    }
+    load->num_pixels = num_pixels;
+    load->needs_conversion = 1;
+    return 1;
+}
+void imagepak::convert_images(pak_load *load, int first, int last) {
+    for (int i = first; i < last; i++) {
+        image *img = &images[i];
+        if (img->draw.is_external)
+            continue;
+        pixel_reader reader = reader_at(load->data_555, load->file_offsets[i]);
+        color_t *dst = img->draw.data;
         if (img->draw.is_fully_compressed)
-            dst += convert_compressed(buf, img->draw.data_length, dst);
+            convert_compressed(&reader, img->draw.data_length, dst);
         else if (img->draw.has_compressed_part) { // isometric tile
-            dst += convert_uncompressed(buf, img->draw.uncompressed_length, dst);
-            dst += convert_compressed(buf, img->draw.data_length - img->draw.uncompressed_length, dst);
+            dst += convert_uncompressed(&reader, img->draw.uncompressed_length, dst);
+            convert_compressed(&reader, img->draw.data_length - img->draw.uncompressed_length, dst);
         } else
-            dst += convert_uncompressed(buf, img->draw.data_length, dst);
+            convert_uncompressed(&reader, img->draw.data_length, dst);
+    }
+}
+void imagepak::finish_load(pak_load *load) {
+    if (!load->needs_conversion)
+        return;
+    for (int i = 0; i < entries_num; i++) {
+        if (!images[i].draw.is_external)
+            images[i].draw.uncompressed_length /= 2;
+    }
+    if (load->use_cache)
+        save_cache(load->cache_path, load->source_info, load->num_pixels);
+    delete[] load->file_offsets;
+    load->file_offsets = nullptr;
+    delete load->data_555;
+    load->data_555 = nullptr;
+}
+static void read_pak_files(int index, void *userdata) {
+    pak_load *load = &((pak_load *) userdata)[index];
+    if (load->result)
+        load->result = load->pak->read_files(load);
+}
+static void convert_pak_images(int index, void *userdata) {
+    conversion_job *job = &((conversion_job *) userdata)[index];
+    job->load->pak->convert_images(job->load, job->first_image, job->last_image);
+}
+static void finish_pak_load(int index, void *userdata) {
+    pak_load *load = &((pak_load *) userdata)[index];
+    load->pak->finish_load(load);
+}
+static int load_paks(pak_load *loads, int num_loads) {
+    for (int i = 0; i < num_loads; i++) {
+        loads[i].result = loads[i].pak->start_load(&loads[i]);
+    }
+    // the paks are independent, so their files are read and parsed at the same time
+    thread_pool_run(num_loads, read_pak_files, loads);
 
-        img->draw.offset = img_offset;
-        img->draw.uncompressed_length /= 2;
-        img->draw.data = &data[img_offset];
-//        SDL_Log("Loading... %s : %i", filename_555, i);
+    // split the conversion of all paks in jobs of similar size
+    std::vector<conversion_job> jobs;
+    for (int i = 0; i < num_loads; i++) {
+        pak_load *load = &loads[i];
+        if (!load->result || !load->needs_conversion)
+            continue;
+        int num_images = load->pak->get_entry_count();
+        conversion_job job = {load, 0, 0};
+        int job_size = 0;
+        for (int image_id = 0; image_id < num_images; image_id++) {
+            job_size += load->pak->get_image(image_id, true)->draw.data_length;
+            if (job_size >= CONVERSION_JOB_SIZE || image_id == num_images - 1) {
+                job.last_image = image_id + 1;
+                jobs.push_back(job);
+                job.first_image = image_id + 1;
+                job_size = 0;
+            }
+        }
     }
+    thread_pool_run((int) jobs.size(), convert_pak_images, jobs.data());
+    thread_pool_run(num_loads, finish_pak_load, loads);
 
-    return 1;
+    int result = 1;
+    for (int i = 0; i < num_loads; i++) {
+        if (!loads[i].result)
+            result = 0;
+    }
+    return result;
+}
+int imagepak::load_555(const char *filename_555, const char *filename_sgx, int shift) {
+    pak_load load;
+    load.pak = this;
+    load.filename_555 = filename_555;
+    load.filename_sgx = filename_sgx;
+    load.shift = shift;
+    return load_paks(&load, 1);
 }
 
 int imagepak::get_entry_count() {
@@ -501,6 +960,26 @@ const image *imagepak::get_image(int id, bool relative) {
         return &DUMMY_IMAGE;
     return &images[id];
 }
+bool imagepak::owns_image(const image *img) {
+    return blocks && img >= images && img < images + entries_num;
+}
+const color_t *imagepak::get_lazy_data(const image *img) {
+    image_block *block = &blocks[image_block_ids[img - images]];
+    block->last_used_frame.store(lazy.frame, std::memory_order_relaxed);
+    const color_t *pixels = block->data.load(std::memory_order_acquire);
+    if (!pixels) {
+        // images are drawn from several threads at once
+        std::lock_guard<std::mutex> lock(lazy.mutex);
+        pixels = block->data.load(std::memory_order_relaxed);
+        if (!pixels)
+            pixels = decode_block(block);
+    }
+    return &pixels[img->draw.offset];
+}
+image_block *imagepak::get_lazy_blocks(int *num) {
+    *num = num_blocks;
+    return blocks;
+}
 
 #include "window/city.h"
 
@@ -593,26 +1072,82 @@ const image *image_letter(int letter_id) {
 const image *image_get_enemy(int id) {
     return data.enemy->get_image(id);
 }
+static imagepak *const *all_paks(int *num_paks) {
+    static imagepak *paks[11];
+    paks[0] = data.ph_expansion;
+    paks[1] = data.ph_sprmain;
+    paks[2] = data.ph_unloaded;
+    paks[3] = data.main;
+    paks[4] = data.ph_terrain;
+    paks[5] = data.ph_sprmain2;
+    paks[6] = data.ph_sprambient;
+    paks[7] = data.ph_mastaba;
+    paks[8] = data.enemy;
+    paks[9] = data.empire;
+    paks[10] = data.font;
+    *num_paks = 11;
+    return paks;
+}
+static const color_t *image_pixels(const image *img) {
+    if (img->draw.data || img == &DUMMY_IMAGE)
+        return img->draw.data;
+    int num_paks;
+    imagepak *const *paks = all_paks(&num_paks);
+    for (int i = 0; i < num_paks; i++) {
+        if (paks[i]->owns_image(img))
+            return paks[i]->get_lazy_data(img);
+    }
+    return NULL;
+}
 const color_t *image_data(int id) {
     const image *lookup = image_get(id);
     const image *img = image_get(id + lookup->offset_mirror);
     if (img->draw.is_external)
         return load_external_data(img);
     else
-        return img->draw.data; // todo: mods
+        return image_pixels(img); // todo: mods
 }
 const color_t *image_data_letter(int letter_id) {
-    return image_letter(letter_id)->draw.data;
+    return image_pixels(image_letter(letter_id));
 }
 const color_t *image_data_enemy(int id) {
     const image *lookup = image_get(id);
     const image *img = image_get(id + lookup->offset_mirror);
     id += img->offset_mirror;
     if (img->draw.offset > 0)
-        return img->draw.data;
+        return image_pixels(img);
     return NULL;
 }
 
+static bool compare_last_used(const image_block *a, const image_block *b) {
+    return a->last_used_frame < b->last_used_frame;
+}
+void image_trim_lazy_data(void) {
+    std::lock_guard<std::mutex> lock(lazy.mutex);
+    size_t budget = (size_t) config_get(CONFIG_UI_LAZY_IMAGE_BUDGET) * 1024 * 1024;
+    if (budget && lazy.decoded_bytes > budget) {
+        // never free what was drawn in the last frame
+        lazy.decoded_blocks.clear();
+        int num_paks;
+        imagepak *const *paks = all_paks(&num_paks);
+        for (int i = 0; i < num_paks; i++) {
+            int num_blocks;
+            image_block *blocks = paks[i]->get_lazy_blocks(&num_blocks);
+            for (int b = 0; b < num_blocks; b++) {
+                if (blocks[b].data.load() && blocks[b].last_used_frame != lazy.frame)
+                    lazy.decoded_blocks.push_back(&blocks[b]);
+            }
+        }
+        std::sort(lazy.decoded_blocks.begin(), lazy.decoded_blocks.end(), compare_last_used);
+        for (size_t i = 0; i < lazy.decoded_blocks.size() && lazy.decoded_bytes > budget; i++) {
+            image_block *block = lazy.decoded_blocks[i];
+            delete[] block->data.exchange(nullptr);
+            lazy.decoded_bytes -= sizeof(color_t) * block->num_pixels;
+        }
+    }
+    lazy.frame++;
+}
+
 int image_load_main(int climate_id, int is_editor, int force_reload) {
 //    image_pak_table_generate();
 
@@ -632,17 +1167,23 @@ int image_load_main(int climate_id, int is_editor, int force_reload) {
         case ENGINE_ENV_PHARAOH:
             filename_555 = is_editor ? gfc.PH_EDITOR_GRAPHICS_555 : gfc.PH_MAIN_555;
             filename_sgx = is_editor ? gfc.PH_EDITOR_GRAPHICS_SG3 : gfc.PH_MAIN_SG3;
-            if (!data.ph_expansion->load_555(gfc.PH_EXPANSION_555, gfc.PH_EXPANSION_SG3, -200)) return 0;
-            if (!data.ph_sprmain->load_555(gfc.PH_SPRMAIN_555, gfc.PH_SPRMAIN_SG3, 700)) return 0;
-            if (!data.ph_unloaded->load_555(gfc.PH_UNLOADED_555, gfc.PH_UNLOADED_SG3, 11025)) return 0;
-            if (!data.main->load_555(filename_555, filename_sgx, 11706)) return 0;
-            // ???? 539-long gap?
-            if (!data.ph_terrain->load_555(gfc.PH_TERRAIN_555, gfc.PH_TERRAIN_SG3, 14252)) return 0;
-            // ???? 64-long gap?
-            if (!data.ph_sprambient->load_555(gfc.PH_SPRAMBIENT_555, gfc.PH_SPRAMBIENT_SG3, 15766+64)) return 0;
-            if (!data.font->load_555(gfc.PH_FONTS_555, gfc.PH_FONTS_SG3, 18764)) return 0;
-            if (!data.empire->load_555(gfc.PH_EMPIRE_555, gfc.PH_EMPIRE_SG3, 18764+1541)) return 0;
+        {
+            pak_load loads[] = {
+                    {data.ph_expansion, gfc.PH_EXPANSION_555, gfc.PH_EXPANSION_SG3, -200},
+                    {data.ph_sprmain, gfc.PH_SPRMAIN_555, gfc.PH_SPRMAIN_SG3, 700},
+                    {data.ph_unloaded, gfc.PH_UNLOADED_555, gfc.PH_UNLOADED_SG3, 11025},
+                    {data.main, filename_555, filename_sgx, 11706},
+                    // ???? 539-long gap?
+                    {data.ph_terrain, gfc.PH_TERRAIN_555, gfc.PH_TERRAIN_SG3, 14252},
+                    // ???? 64-long gap?
+                    {data.ph_sprambient, gfc.PH_SPRAMBIENT_555, gfc.PH_SPRAMBIENT_SG3, 15766+64},
+                    {data.font, gfc.PH_FONTS_555, gfc.PH_FONTS_SG3, 18764},
+                    {data.empire, gfc.PH_EMPIRE_555, gfc.PH_EMPIRE_SG3, 18764+1541},
+            };
+            if (!load_paks(loads, sizeof(loads) / sizeof(pak_load)))
+                return 0;
             break;
+        }
     }
 
     data.is_editor = is_editor;
@@ -5,6 +5,9 @@
 #include "core/image_group.h"
 #include "graphics/color.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 #define IMAGE_FONT_MULTIBYTE_OFFSET 10000
 #define IMAGE_FONT_MULTIBYTE_TRAD_CHINESE_MAX_CHARS 2188
 #define IMAGE_FONT_MULTIBYTE_SIMP_CHINESE_MAX_CHARS 2130
@@ -47,6 +50,9 @@ typedef struct {
     } draw;
 } image;
 
+struct image_block;
+struct pak_load;
+
 class imagepak {
     bool initialized;
     const char *name;
@@ -56,8 +62,18 @@ class imagepak {
     uint16_t *group_image_ids;
     image *images;
     color_t *data;
-
-    bool check_initialized();
+    const void *cache_mapping;
+    size_t cache_mapping_size;
+    image_block *blocks;
+    int num_blocks;
+    int *image_block_ids;
+    char *lazy_filename_555;
+
+    void release();
+    void prepare_lazy_blocks(const char *filename_555);
+    const color_t *decode_block(image_block *block);
+    bool load_cache(const char *cache_path, const int64_t *source_info);
+    void save_cache(const char *cache_path, const int64_t *source_info, int num_pixels);
 
 public:
     int id_shift_overall = 0;
@@ -66,9 +82,19 @@ public:
 
     int load_555(const char *filename_555, const char *filename_sgx, int shift = 0);
 
+    // steps of load_555, see load_paks
+    int start_load(pak_load *load);
+    int read_files(pak_load *load);
+    void convert_images(pak_load *load, int first, int last);
+    void finish_load(pak_load *load);
+
     int get_entry_count();
     int get_id(int group);
     const image *get_image(int id, bool relative = false);
+
+    bool owns_image(const image *img);
+    const color_t *get_lazy_data(const image *img);
+    image_block *get_lazy_blocks(int *num);
 };
 
 extern int terrain_ph_offset;
@@ -86,4 +112,10 @@ const color_t *image_data(int id);
 const color_t *image_data_letter(int letter_id);
 const color_t *image_data_enemy(int id);
 
+/**
+ * Frees the least recently drawn images that were decoded on first use until
+ * they fit in the configured budget again. Must be called between frames.
+ */
+void image_trim_lazy_data(void);
+
 #endif // CORE_IMAGE_H
@@ -0,0 +1,136 @@
+#include "core/profiler.h"
+
+#include "core/file.h"
+#include "core/log.h"
+
+#include <chrono>
+#include <string.h>
+
+#define MAX_SAMPLES 65536
+#define SAMPLE_MASK (MAX_SAMPLES - 1)
+#define WINDOW_NS 1000000000ULL
+
+typedef struct {
+    uint32_t frame;
+    uint8_t section;
+    int8_t slot;
+    uint32_t duration_ns;
+} profiler_sample;
+
+static const char *SECTION_NAMES[PROFILER_MAX_SECTIONS] = {
+        "game_run",
+        "game_draw",
+        "tick_slot",
+        "figure_actions",
+        "route_figure",
+        "route_distances",
+        "river_tiles",
+        "draw_footprints",
+        "draw_tops_figures",
+        "draw_ghost",
+        "draw_elevated",
+        "draw_deleting",
+};
+
+int profiler_enabled = 0;
+
+static struct {
+    profiler_sample samples[MAX_SAMPLES];
+    uint32_t next_sample;
+    uint32_t frame;
+    uint64_t window_start_ns;
+    profiler_stats sections[PROFILER_MAX_SECTIONS];
+    profiler_stats slots[PROFILER_NUM_TICK_SLOTS];
+    profiler_stats last_sections[PROFILER_MAX_SECTIONS];
+    profiler_stats last_slots[PROFILER_NUM_TICK_SLOTS];
+    uint64_t last_duration_ns[PROFILER_MAX_SECTIONS];
+} data;
+
+static void add_to_stats(profiler_stats *stats, uint64_t duration_ns) {
+    stats->calls++;
+    stats->total_ns += duration_ns;
+    if (duration_ns > stats->max_ns)
+        stats->max_ns = duration_ns;
+}
+
+uint64_t profiler_now(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void profiler_record(profiler_section section, int slot, uint64_t start_ns) {
+    if (!profiler_enabled)
+        return;
+    uint64_t duration_ns = profiler_now() - start_ns;
+    profiler_sample *sample = &data.samples[data.next_sample & SAMPLE_MASK];
+    data.next_sample++;
+    sample->frame = data.frame;
+    sample->section = section;
+    sample->slot = slot;
+    sample->duration_ns = duration_ns > UINT32_MAX ? UINT32_MAX : (uint32_t) duration_ns;
+
+    data.last_duration_ns[section] = duration_ns;
+    add_to_stats(&data.sections[section], duration_ns);
+    if (slot >= 0 && slot < PROFILER_NUM_TICK_SLOTS)
+        add_to_stats(&data.slots[slot], duration_ns);
+}
+
+void profiler_end_frame(void) {
+    if (!profiler_enabled)
+        return;
+    data.frame++;
+    uint64_t now = profiler_now();
+    if (now - data.window_start_ns < WINDOW_NS)
+        return;
+    memcpy(data.last_sections, data.sections, sizeof(data.sections));
+    memcpy(data.last_slots, data.slots, sizeof(data.slots));
+    memset(data.sections, 0, sizeof(data.sections));
+    memset(data.slots, 0, sizeof(data.slots));
+    data.window_start_ns = now;
+}
+
+void profiler_toggle(void) {
+    memset(&data, 0, sizeof(data));
+    profiler_enabled = !profiler_enabled;
+    if (profiler_enabled)
+        data.window_start_ns = profiler_now();
+}
+
+const char *profiler_section_name(profiler_section section) {
+    return SECTION_NAMES[section];
+}
+
+const profiler_stats *profiler_get_section_stats(profiler_section section) {
+    return &data.last_sections[section];
+}
+
+const profiler_stats *profiler_get_slot_stats(int slot) {
+    return &data.last_slots[slot];
+}
+
+uint64_t profiler_get_last_duration(profiler_section section) {
+    return data.last_duration_ns[section];
+}
+
+int profiler_dump(const char *filename) {
+    FILE *fp = file_open(filename, "w");
+    if (!fp) {
+        log_error("Unable to write profiler dump", filename, 0);
+        return 0;
+    }
+    fprintf(fp, "frame,section,slot,duration_us\n");
+    uint32_t first = data.next_sample > MAX_SAMPLES ? data.next_sample - MAX_SAMPLES : 0;
+    for (uint32_t i = first; i != data.next_sample; i++) {
+        const profiler_sample *sample = &data.samples[i & SAMPLE_MASK];
+        fprintf(fp, "%u,%s,%d,%.3f\n", sample->frame, SECTION_NAMES[sample->section], sample->slot,
+                sample->duration_ns / 1000.0);
+    }
+    fprintf(fp, "\nslot,calls,total_us,max_us\n");
+    for (int slot = 0; slot < PROFILER_NUM_TICK_SLOTS; slot++) {
+        const profiler_stats *stats = &data.last_slots[slot];
+        fprintf(fp, "%d,%d,%.3f,%.3f\n", slot, stats->calls, stats->total_ns / 1000.0, stats->max_ns / 1000.0);
+    }
+    file_close(fp);
+    log_info("Profiler samples written to", filename, 0);
+    return 1;
+}
@@ -0,0 +1,122 @@
+#ifndef CORE_PROFILER_H
+#define CORE_PROFILER_H
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Low-overhead timing of game subsystems.
+ *
+ * Timed scopes are only recorded while the profiler is enabled. Every sample goes into a ring buffer
+ * that can be dumped to a file, and is also summed per section and per tick slot for the overlay.
+ */
+
+#define PROFILER_NUM_TICK_SLOTS 51
+
+typedef enum {
+    PROFILER_GAME_RUN,
+    PROFILER_GAME_DRAW,
+    PROFILER_TICK_SLOT,
+    PROFILER_FIGURE_ACTIONS,
+    PROFILER_ROUTE_FIGURE,
+    PROFILER_ROUTE_DISTANCES,
+    PROFILER_RIVER_TILES,
+    PROFILER_DRAW_FOOTPRINTS,
+    PROFILER_DRAW_TOPS_FIGURES,
+    PROFILER_DRAW_GHOST,
+    PROFILER_DRAW_ELEVATED,
+    PROFILER_DRAW_DELETING,
+    PROFILER_MAX_SECTIONS
+} profiler_section;
+
+typedef struct {
+    int calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} profiler_stats;
+
+extern int profiler_enabled;
+
+/**
+ * Gets a timestamp for measuring durations
+ * @return Monotonic time in nanoseconds
+ */
+uint64_t profiler_now(void);
+
+/**
+ * Records a sample that started at the given time and ends now
+ * @param section Section that was timed
+ * @param slot Tick slot the sample belongs to, or -1
+ * @param start_ns Start time as returned by profiler_now()
+ */
+void profiler_record(profiler_section section, int slot, uint64_t start_ns);
+
+/**
+ * Closes the current frame: once a second the running totals become the statistics shown by the overlay
+ */
+void profiler_end_frame(void);
+
+/**
+ * Turns the profiler on or off, clearing all samples
+ */
+void profiler_toggle(void);
+
+/**
+ * Gets the name of a section
+ * @param section Section
+ * @return Name
+ */
+const char *profiler_section_name(profiler_section section);
+
+/**
+ * Gets the statistics of the last completed second for a section
+ * @param section Section
+ * @return Statistics
+ */
+const profiler_stats *profiler_get_section_stats(profiler_section section);
+
+/**
+ * Gets the statistics of the last completed second for a tick slot
+ * @param slot Tick slot
+ * @return Statistics
+ */
+const profiler_stats *profiler_get_slot_stats(int slot);
+
+/**
+ * Gets the duration of the most recent sample of a section
+ * @param section Section
+ * @return Duration in nanoseconds, 0 if none was recorded since the profiler was turned on
+ */
+uint64_t profiler_get_last_duration(profiler_section section);
+
+/**
+ * Writes all samples in the ring buffer and the per-slot totals to a CSV file
+ * @param filename File to write
+ * @return 1 on success, 0 on failure
+ */
+int profiler_dump(const char *filename);
+
+/**
+ * Times the enclosing block while the profiler is enabled
+ */
+class profiler_scope {
+public:
+    explicit profiler_scope(profiler_section section, int slot = -1)
+        : section(section), slot(slot), active(profiler_enabled), start_ns(active ? profiler_now() : 0) {
+    }
+    ~profiler_scope() {
+        if (active)
+            profiler_record(section, slot, start_ns);
+    }
+private:
+    profiler_section section;
+    int slot;
+    int active;
+    uint64_t start_ns;
+};
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+#define PROFILE_SCOPE(...) profiler_scope PROFILER_CONCAT(profile_scope_, __LINE__)(__VA_ARGS__)
+
+#endif // CORE_PROFILER_H
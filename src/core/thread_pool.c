@@ -0,0 +1,116 @@
+#include "core/thread_pool.h"
+
+#define MAX_THREADS 8
+
+#if defined(__vita__) || defined(__SWITCH__)
+
+int thread_pool_size(void) {
+    return 1;
+}
+
+void thread_pool_run(int num_jobs, void (*job)(int index, void *userdata), void *userdata) {
+    for (int i = 0; i < num_jobs; i++)
+        job(i, userdata);
+}
+
+#else
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+static struct pool {
+    std::thread workers[MAX_THREADS - 1];
+    int num_workers;
+    int started;
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_finished;
+    void (*job)(int index, void *userdata);
+    void *userdata;
+    int num_jobs;
+    int next_job;
+    int jobs_running;
+    int busy;
+    unsigned int generation;
+    int stopping;
+
+    ~pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = 1;
+        }
+        work_available.notify_all();
+        for (int i = 0; i < num_workers; i++)
+            workers[i].join();
+    }
+} pool;
+
+// takes jobs until none are left; called with the mutex held
+static void take_jobs(std::unique_lock<std::mutex> &lock) {
+    while (pool.next_job < pool.num_jobs) {
+        int index = pool.next_job++;
+        pool.jobs_running++;
+        lock.unlock();
+        pool.job(index, pool.userdata);
+        lock.lock();
+        pool.jobs_running--;
+    }
+    if (!pool.jobs_running)
+        pool.work_finished.notify_all();
+}
+
+static void worker_loop(void) {
+    unsigned int seen_generation = 0;
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    while (1) {
+        pool.work_available.wait(lock, [&] { return pool.stopping || pool.generation != seen_generation; });
+        if (pool.stopping)
+            return;
+        seen_generation = pool.generation;
+        take_jobs(lock);
+    }
+}
+
+static void start_workers(void) {
+    pool.started = 1;
+    int num_threads = (int) std::thread::hardware_concurrency();
+    if (num_threads > MAX_THREADS)
+        num_threads = MAX_THREADS;
+    for (int i = 0; i < num_threads - 1; i++) {
+        pool.workers[i] = std::thread(worker_loop);
+        pool.num_workers++;
+    }
+}
+
+int thread_pool_size(void) {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (!pool.started)
+        start_workers();
+    return pool.num_workers + 1;
+}
+
+void thread_pool_run(int num_jobs, void (*job)(int index, void *userdata), void *userdata) {
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    if (!pool.started)
+        start_workers();
+    if (pool.busy || !pool.num_workers || num_jobs <= 1) {
+        lock.unlock();
+        for (int i = 0; i < num_jobs; i++)
+            job(i, userdata);
+        return;
+    }
+    pool.busy = 1;
+    pool.job = job;
+    pool.userdata = userdata;
+    pool.num_jobs = num_jobs;
+    pool.next_job = 0;
+    pool.generation++;
+    pool.work_available.notify_all();
+
+    take_jobs(lock);
+    pool.work_finished.wait(lock, [] { return pool.next_job >= pool.num_jobs && !pool.jobs_running; });
+    pool.busy = 0;
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef CORE_THREAD_POOL_H
+#define CORE_THREAD_POOL_H
+
+/**
+ * @file
+ * Worker threads for splitting work into independent jobs.
+ */
+
+/**
+ * Gets the number of threads that run jobs, including the calling thread
+ * @return Number of threads, 1 if the platform has no worker threads
+ */
+int thread_pool_size(void);
+
+/**
+ * Runs job(index, userdata) for every index from 0 to num_jobs - 1 and waits until all jobs are done.
+ * The calling thread takes jobs as well. Jobs run one after another on the calling thread
+ * when there are no workers or when the pool is already busy.
+ * @param num_jobs Number of jobs
+ * @param job Function to run for every job
+ * @param userdata Passed to every job
+ */
+void thread_pool_run(int num_jobs, void (*job)(int index, void *userdata), void *userdata);
+
+#endif // CORE_THREAD_POOL_H
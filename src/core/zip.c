@@ -18,6 +18,14 @@ enum {
     PK_EOF = 773,
 };
 
+// positions in the hash chains are kept for twice the largest dictionary
+#define PK_HASH_RING_SIZE 8192
+
+struct pk_copy_length_offset {
+    int length;
+    uint16_t offset;
+};
+
 struct pk_token {
     int stop;
 
@@ -53,6 +61,16 @@ struct pk_comp_buffer {
 
     uint16_t codeword_values[774];
     uint8_t codeword_bits[774];
+
+    // hash chain match finder, see pk_implode_find_chained_copy
+    int max_chain_length;
+    int nice_length;
+    int input_base;
+    int next_hash_index;
+    int cached_copy_index;
+    struct pk_copy_length_offset cached_copy;
+    int hash_head[65536];
+    int hash_prev[PK_HASH_RING_SIZE];
 };
 
 struct pk_decomp_buffer {
@@ -75,11 +93,6 @@ struct pk_decomp_buffer {
     uint8_t copy_length_jump_table[256];
 };
 
-struct pk_copy_length_offset {
-    int length;
-    uint16_t offset;
-};
-
 static const uint8_t pk_copy_offset_bits[64] = {
         2, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6,
         6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
@@ -116,6 +129,23 @@ static const uint8_t pk_copy_length_extra_bits[16] = {
         0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8,
 };
 
+// chain length and good-enough match length per compression level; level 0 uses the original exhaustive search
+static const struct {
+    int max_chain_length;
+    int nice_length;
+} pk_levels[ZIP_LEVEL_BEST + 1] = {
+        {0, 0},
+        {4, 16},
+        {8, 32},
+        {16, 64},
+        {32, 128},
+        {64, 258},
+        {128, 516},
+        {256, 516},
+        {1024, 516},
+        {4096, 516},
+};
+
 static void pk_memcpy(uint8_t *dst, const uint8_t *src, int length) {
     for (int i = 0; i < length; i++) {
         dst[i] = src[i];
@@ -331,10 +361,65 @@ static void pk_implode_determine_copy(struct pk_comp_buffer *buf, int input_inde
     }
     // never reached
 }
+static void pk_implode_find_chained_copy(struct pk_comp_buffer *buf, int input_index, struct pk_copy_length_offset *copy) {
+    // chain every position that can start a copy: the two bytes before input_index cannot
+    while (buf->next_hash_index < input_index - 1) {
+        int index = buf->next_hash_index++;
+        int key = buf->input_data[index] | (buf->input_data[index + 1] << 8);
+        int position = buf->input_base + index;
+        buf->hash_prev[position & (PK_HASH_RING_SIZE - 1)] = buf->hash_head[key];
+        buf->hash_head[key] = position;
+    }
+    const uint8_t *input_ptr = &buf->input_data[input_index];
+    int min_position = buf->input_base + input_index - buf->dictionary_size + 1;
+    int max_length = (int) sizeof(buf->input_data) - input_index;
+    if (max_length > 516)
+        max_length = 516;
+
+    int best_length = 1;
+    int best_index = 0;
+    int chain_length = buf->max_chain_length;
+    int position = buf->hash_head[input_ptr[0] | (input_ptr[1] << 8)];
+    // positions start above the dictionary size, so an empty head or link ends the chain
+    while (position >= min_position && chain_length-- > 0) {
+        const uint8_t *match_ptr = &buf->input_data[position - buf->input_base];
+        // the first two bytes are equal by the hash key; newer positions come first, so equal lengths keep the nearest
+        if (best_length < 2 || match_ptr[best_length] == input_ptr[best_length]) {
+            int length = 2;
+            while (length < max_length && match_ptr[length] == input_ptr[length])
+                length++;
+
+            if (length > best_length) {
+                best_length = length;
+                best_index = position - buf->input_base;
+                if (length >= buf->nice_length || length >= max_length)
+                    break;
+
+            }
+        }
+        position = buf->hash_prev[position & (PK_HASH_RING_SIZE - 1)];
+    }
+    copy->length = best_length < 2 ? 0 : best_length;
+    copy->offset = (uint16_t) (input_index - best_index - 1);
+}
+static void pk_implode_find_copy(struct pk_comp_buffer *buf, int input_index, struct pk_copy_length_offset *copy) {
+    if (!buf->max_chain_length) {
+        pk_implode_determine_copy(buf, input_index, copy);
+        return;
+    }
+    // the lookahead for a better copy asks for the same index as the next step
+    if (input_index == buf->cached_copy_index) {
+        *copy = buf->cached_copy;
+        return;
+    }
+    pk_implode_find_chained_copy(buf, input_index, copy);
+    buf->cached_copy_index = input_index;
+    buf->cached_copy = *copy;
+}
 static int pk_implode_next_copy_is_better(struct pk_comp_buffer *buf, int offset,
                                           const struct pk_copy_length_offset *current_copy) {
     struct pk_copy_length_offset next_copy;
-    pk_implode_determine_copy(buf, offset + 1, &next_copy);
+    pk_implode_find_copy(buf, offset + 1, &next_copy);
     if (current_copy->length >= next_copy.length)
         return 0;
 
@@ -344,6 +429,9 @@ static int pk_implode_next_copy_is_better(struct pk_comp_buffer *buf, int offset
     return 1;
 }
 static void pk_implode_analyze_input(struct pk_comp_buffer *buf, int input_start, int input_end) {
+    if (buf->max_chain_length)
+        return; // the hash chains are filled while compressing
+
     memset(buf->analyze_offset_table, 0, sizeof(buf->analyze_offset_table));
     for (int index = input_start; index < input_end; index++) {
         buf->analyze_offset_table[4 * buf->input_data[index] + 5 * buf->input_data[index + 1]]++;
@@ -371,6 +459,7 @@ static void pk_implode_data(struct pk_comp_buffer *buf) {
 
     int input_ptr = buf->dictionary_size + 516;
     pk_memset(&buf->output_data[2], 0, 2048);
+    buf->next_hash_index = input_ptr;
 
     buf->current_output_bits_used = 0;
 
@@ -404,7 +493,7 @@ static void pk_implode_data(struct pk_comp_buffer *buf) {
             int write_literal = 0;
             int write_copy = 0;
             struct pk_copy_length_offset copy;
-            pk_implode_determine_copy(buf, input_ptr, &copy);
+            pk_implode_find_copy(buf, input_ptr, &copy);
 
             if (copy.length == 0)
                 write_literal = 1;
@@ -439,6 +528,9 @@ static void pk_implode_data(struct pk_comp_buffer *buf) {
         if (!eof) {
             input_ptr -= 4096;
             pk_memcpy(buf->input_data, &buf->input_data[4096], buf->dictionary_size + 516);
+            buf->input_base += 4096;
+            buf->next_hash_index -= 4096;
+            buf->cached_copy_index = 0;
         }
     }
 
@@ -451,7 +543,7 @@ static void pk_implode_data(struct pk_comp_buffer *buf) {
 }
 static int
 pk_implode(pk_input_func *input_func, pk_output_func *output_func, struct pk_comp_buffer *buf, struct pk_token *token,
-           int dictionary_size) {
+           int dictionary_size, int level) {
     buf->input_func = input_func;
     buf->output_func = output_func;
     buf->dictionary_size = dictionary_size;
@@ -468,6 +560,12 @@ pk_implode(pk_input_func *input_func, pk_output_func *output_func, struct pk_com
     } else {
         return PK_INVALID_WINDOWSIZE;
     }
+    if (level < 0)
+        level = 0;
+    else if (level > ZIP_LEVEL_BEST)
+        level = ZIP_LEVEL_BEST;
+    buf->max_chain_length = pk_levels[level].max_chain_length;
+    buf->nice_length = pk_levels[level].nice_length;
 
     for (int i = 0; i < 256; i++) {
         buf->codeword_bits[i] = 9; // 8 + 1 for leading zero
@@ -680,7 +778,7 @@ static void zip_output_func(uint8_t *buffer, int length, struct pk_token *token)
         token->stop = 1;
     }
 }
-int zip_compress(const void *input_buffer, int input_length, void *output_buffer, int *output_length) {
+int zip_compress(const void *input_buffer, int input_length, void *output_buffer, int *output_length, int level) {
     struct pk_token token;
     struct pk_comp_buffer *buf = (struct pk_comp_buffer *) malloc(sizeof(struct pk_comp_buffer));
 
@@ -696,7 +794,7 @@ int zip_compress(const void *input_buffer, int input_length, void *output_buffer
     token.output_length = *output_length;
 
     int ok = 1;
-    int pk_error = pk_implode(zip_input_func, zip_output_func, buf, &token, 4096);
+    int pk_error = pk_implode(zip_input_func, zip_output_func, buf, &token, 4096, level);
     if (pk_error || token.stop) {
         log_error("COMP Error occurred while compressing.", 0, 0);
         ok = 0;
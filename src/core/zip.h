@@ -6,15 +6,28 @@
  * Compression functions.
  */
 
+/**
+ * Compression levels: higher levels search further back for matches, trading speed for size.
+ * Level 0 is the exhaustive search of the original game, which is the slowest.
+ * All levels produce the same PKWare format.
+ */
+enum {
+    ZIP_LEVEL_ORIGINAL = 0,
+    ZIP_LEVEL_FASTEST = 1,
+    ZIP_LEVEL_DEFAULT = 6,
+    ZIP_LEVEL_BEST = 9
+};
+
 /**
  * Compresses the input buffer.
  * @param input_buffer Input buffer to compress
  * @param input_length Length of input buffer
  * @param output_buffer Output buffer to write the compressed data to
  * @param output_length IN: available length of the output buffer, OUT: written bytes
+ * @param level Compression level, one of ZIP_LEVEL_* or in between
  * @return boolean true on success, false on error
  */
-int zip_compress(const void *input_buffer, int input_length, void *output_buffer, int *output_length);
+int zip_compress(const void *input_buffer, int input_length, void *output_buffer, int *output_length, int level);
 
 /**
  * Decompresses the input buffer
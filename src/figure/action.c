@@ -23,6 +23,7 @@
 #include "figuretype/wall.h"
 #include "figuretype/water.h"
 #include "core/game_environment.h"
+#include "core/profiler.h"
 #include "map/road_access.h"
 #include "core/image_group.h"
 
@@ -496,8 +497,9 @@ void figure::action_perform() {
 
 void figure_action_handle(void) {
 //    return;
+    PROFILE_SCOPE(PROFILER_FIGURE_ACTIONS);
     city_figures_reset();
     city_entertainment_set_hippodrome_has_race(0);
-    for (int i = 1; i < MAX_FIGURES[GAME_ENV]; i++)
+    for (int i = figure_next_live_id(0); i; i = figure_next_live_id(i))
         figure_get(i)->action_perform();
 }
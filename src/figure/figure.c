@@ -16,22 +16,92 @@ static struct {
     int created_sequence;
     bool initialized;
     figure *figures[5000];
+    // ids of the figures in use, sorted
+    short live_ids[5000];
+    int num_live;
+    // min-heap of unused ids, so a new figure still gets the lowest free id
+    short free_ids[5000];
+    int num_free;
 } data = {0, false};
 
+static int find_live_index(int id) {
+    int low = 0;
+    int high = data.num_live;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (data.live_ids[mid] < id)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+static void add_live(int id) {
+    int index = find_live_index(id);
+    memmove(&data.live_ids[index + 1], &data.live_ids[index], (data.num_live - index) * sizeof(short));
+    data.live_ids[index] = id;
+    data.num_live++;
+}
+static void remove_live(int id) {
+    int index = find_live_index(id);
+    if (index >= data.num_live || data.live_ids[index] != id)
+        return;
+    data.num_live--;
+    memmove(&data.live_ids[index], &data.live_ids[index + 1], (data.num_live - index) * sizeof(short));
+}
+static void push_free(int id) {
+    int index = data.num_free++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (data.free_ids[parent] <= id)
+            break;
+        data.free_ids[index] = data.free_ids[parent];
+        index = parent;
+    }
+    data.free_ids[index] = id;
+}
+static int pop_free(void) {
+    int lowest = data.free_ids[0];
+    int last = data.free_ids[--data.num_free];
+    int index = 0;
+    while (1) {
+        int child = 2 * index + 1;
+        if (child >= data.num_free)
+            break;
+        if (child + 1 < data.num_free && data.free_ids[child + 1] < data.free_ids[child])
+            child++;
+        if (last <= data.free_ids[child])
+            break;
+        data.free_ids[index] = data.free_ids[child];
+        index = child;
+    }
+    data.free_ids[index] = last;
+    return lowest;
+}
+static void rebuild_figure_lists(void) {
+    data.num_live = 0;
+    data.num_free = 0;
+    for (int i = 1; i < MAX_FIGURES[GAME_ENV]; i++) {
+        if (figure_get(i)->available())
+            push_free(i);
+        else
+            data.live_ids[data.num_live++] = i;
+    }
+}
+
 figure *figure_get(int id) {
     return data.figures[id];
 }
+int figure_next_live_id(int id) {
+    int index = find_live_index(id + 1);
+    return index < data.num_live ? data.live_ids[index] : 0;
+}
 figure *figure_create(int type, int x, int y, int dir) {
-    int id = 0;
-    for (int i = 1; i < MAX_FIGURES[GAME_ENV]; i++) {
-        if (figure_get(i)->available()) {
-            id = i;
-            break;
-        }
-    }
-    if (!id)
+    if (!data.num_free)
         return figure_get(0);
 
+    int id = pop_free();
+    add_live(id);
     figure *f = figure_get(id);
     f->state = FIGURE_STATE_ALIVE;
     f->faction_id = 1;
@@ -90,6 +160,10 @@ void figure::figure_delete_UNSAFE() {
     map_figure_remove();
 
     int figure_id = id;
+    if (state != FIGURE_STATE_NONE && figure_id > 0 && figure_id < MAX_FIGURES[GAME_ENV]) {
+        remove_live(figure_id);
+        push_free(figure_id);
+    }
     state = FIGURE_STATE_NONE;
     memset(this, 0, sizeof(figure));
     id = figure_id;
@@ -121,9 +195,10 @@ void init_figures() {
 void figure_init_scenario(void) {
     init_figures();
     data.created_sequence = 0;
+    rebuild_figure_lists();
 }
 void figure_kill_all() {
-    for (int i = 1; i < MAX_FIGURES[GAME_ENV]; i++)
+    for (int i = figure_next_live_id(0); i; i = figure_next_live_id(i))
         figure_get(i)->poof();
 }
 void figure::save(buffer *buf) {
@@ -387,4 +462,5 @@ void figure_load_state(buffer *list, buffer *seq) {
         figure_get(i)->load(list);
         figure_get(i)->id = i;
     }
+    rebuild_figure_lists();
 }
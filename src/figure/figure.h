@@ -410,6 +410,14 @@ public:
 
 figure *figure_get(int id);
 
+/**
+ * Gets the next figure in use after the given id, to walk all figures in id order.
+ * Figures created or deleted during the walk are handled like a scan over all slots would.
+ * @param id Figure id to start after, 0 to get the first figure
+ * @return Figure id, or 0 if there are no more figures
+ */
+int figure_next_live_id(int id);
+
 /**
  * Creates a figure
  * @param type Figure type
@@ -1,18 +1,120 @@
 #include "route.h"
 
+#include "map/grid.h"
 #include "map/routing.h"
 #include "map/routing_path.h"
+#include "map/routing_terrain.h"
 #include "core/game_environment.h"
+#include "core/profiler.h"
+
+#include <stdlib.h>
+#include <string.h>
 
 #define MAX_PATH_LENGTH 500
 #define MAX_ROUTES 3000
+#define MAX_CACHED_PATHS 1024
 
 static struct {
     int figure_ids[MAX_ROUTES];
     uint8_t direction_paths[MAX_ROUTES][MAX_PATH_LENGTH];
 } data;
 
+// Paths that only depend on road or wall terrain, pointing at the route slot that holds
+// the directions. An entry is dropped when its slot gets a new path, or when the
+// passability of a tile that is close enough to the source to change the search result flips.
+typedef struct {
+    int src_offset;
+    int dst_offset;
+    int terrain_usage;
+    int path_id;
+    int path_length; // 0: empty entry
+    int search_distance;
+} cached_path;
+
+static struct {
+    cached_path entries[MAX_CACHED_PATHS];
+    int entry_for_path[MAX_ROUTES]; // entry index + 1, 0 if the slot isn't cached
+    int hits;
+    int misses;
+} cache;
+
+static void cache_clear(void) {
+    memset(cache.entries, 0, sizeof(cache.entries));
+    memset(cache.entry_for_path, 0, sizeof(cache.entry_for_path));
+}
+static void cache_remove_entry(int index) {
+    cached_path *entry = &cache.entries[index];
+    if (entry->path_length)
+        cache.entry_for_path[entry->path_id] = 0;
+    entry->path_length = 0;
+}
+static void cache_apply_terrain_changes(void) {
+    const int *offsets;
+    int num_changes = map_routing_passability_changes(&offsets);
+    if (num_changes < 0)
+        cache_clear();
+    for (int c = 0; c < num_changes; c++) {
+        int x = map_grid_offset_to_x(offsets[c]);
+        int y = map_grid_offset_to_y(offsets[c]);
+        for (int i = 0; i < MAX_CACHED_PATHS; i++) {
+            const cached_path *entry = &cache.entries[i];
+            if (!entry->path_length)
+                continue;
+            // the walk back only looks at tiles the search reached within the distance of the
+            // destination, so a tile further away from the source can't change the path
+            int distance = abs(x - map_grid_offset_to_x(entry->src_offset)) +
+                           abs(y - map_grid_offset_to_y(entry->src_offset));
+            if (distance <= entry->search_distance)
+                cache_remove_entry(i);
+        }
+    }
+    map_routing_passability_changes_clear();
+}
+static int cache_index(int src_offset, int dst_offset, int terrain_usage) {
+    unsigned int hash = (unsigned int) src_offset * 2654435761u;
+    hash ^= (unsigned int) dst_offset * 40503u + (unsigned int) terrain_usage;
+    return (int) ((hash ^ (hash >> 16)) & (MAX_CACHED_PATHS - 1));
+}
+static int cache_entry_matches(const cached_path *entry, int src_offset, int dst_offset, int terrain_usage) {
+    return entry->path_length && entry->src_offset == src_offset && entry->dst_offset == dst_offset &&
+           entry->terrain_usage == terrain_usage;
+}
+static const cached_path *cache_lookup(int src_offset, int dst_offset, int terrain_usage) {
+    const cached_path *entry = &cache.entries[cache_index(src_offset, dst_offset, terrain_usage)];
+    if (cache_entry_matches(entry, src_offset, dst_offset, terrain_usage)) {
+        cache.hits++;
+        return entry;
+    }
+    cache.misses++;
+    return 0;
+}
+static void cache_store(int src_offset, int dst_offset, int terrain_usage, int path_id, int path_length) {
+    int search_distance = map_routing_distance(dst_offset) - 1;
+    int index = cache_index(src_offset, dst_offset, terrain_usage);
+    cache_remove_entry(index);
+    cached_path *entry = &cache.entries[index];
+    entry->src_offset = src_offset;
+    entry->dst_offset = dst_offset;
+    entry->terrain_usage = terrain_usage;
+    entry->path_id = path_id;
+    entry->path_length = path_length;
+    entry->search_distance = search_distance;
+    cache.entry_for_path[path_id] = index + 1;
+}
+static int is_cacheable_usage(int terrain_usage) {
+    return terrain_usage == TERRAIN_USAGE_ROADS || terrain_usage == TERRAIN_USAGE_PREFER_ROADS ||
+           terrain_usage == TERRAIN_USAGE_WALLS;
+}
+
+int figure_route_cache_hits(void) {
+    return cache.hits;
+}
+int figure_route_cache_misses(void) {
+    return cache.misses;
+}
+
 void figure_route_clear_all(void) {
+    cache_clear();
     for (int i = 0; i < MAX_ROUTES; i++) {
         data.figure_ids[i] = 0;
         for (int j = 0; j < MAX_PATH_LENGTH; j++) {
@@ -41,6 +143,7 @@ static int get_first_available(void) {
 }
 
 void figure::figure_route_add() {
+    PROFILE_SCOPE(PROFILER_ROUTE_FIGURE);
     routing_path_id = 0;
     routing_path_current_tile = 0;
     routing_path_length = 0;
@@ -48,6 +151,30 @@ void figure::figure_route_add() {
     if (!path_id)
         return;
     int path_length;
+    int src_offset = map_grid_offset(tile_x, tile_y);
+    int dst_offset = map_grid_offset(destination_x, destination_y);
+    int is_cacheable = !is_boat && is_cacheable_usage(terrain_usage);
+    if (is_cacheable)
+        cache_apply_terrain_changes();
+    // the slot gets a new path, so a cached path stored in it is gone, unless it's the one asked for
+    if (cache.entry_for_path[path_id]) {
+        int index = cache.entry_for_path[path_id] - 1;
+        if (!is_cacheable || !cache_entry_matches(&cache.entries[index], src_offset, dst_offset, terrain_usage))
+            cache_remove_entry(index);
+    }
+    if (is_cacheable) {
+        const cached_path *cached = cache_lookup(src_offset, dst_offset, terrain_usage);
+        if (cached) {
+            if (cached->path_id != path_id)
+                memcpy(data.direction_paths[path_id], data.direction_paths[cached->path_id], cached->path_length);
+            map_routing_count_cached_route();
+            data.figure_ids[path_id] = id;
+            routing_path_id = path_id;
+            routing_path_length = cached->path_length;
+            return;
+        }
+    }
+    int path_from_roads = 0;
     if (is_boat) {
         if (is_boat == 2) { // flotsam
             map_routing_calculate_distances_water_flotsam(tile_x, tile_y);
@@ -59,6 +186,7 @@ void figure::figure_route_add() {
     } else {
         // land figure
         int can_travel;
+        map_routing_set_point_to_point(1);
         switch (terrain_usage) {
             case TERRAIN_USAGE_ENEMY:
                 can_travel = map_routing_noncitizen_can_travel_over_land(tile_x, tile_y, destination_x, destination_y, destination_building_id, 5000);
@@ -76,6 +204,7 @@ void figure::figure_route_add() {
                 break;
             case TERRAIN_USAGE_PREFER_ROADS:
                 can_travel = map_routing_citizen_can_travel_over_road(tile_x, tile_y, destination_x, destination_y);
+                path_from_roads = can_travel;
                 if (!can_travel)
                     can_travel = map_routing_citizen_can_travel_over_land(tile_x, tile_y, destination_x, destination_y);
                 break;
@@ -86,6 +215,7 @@ void figure::figure_route_add() {
                 can_travel = map_routing_citizen_can_travel_over_land(tile_x, tile_y, destination_x, destination_y);
                 break;
         }
+        map_routing_set_point_to_point(0);
         if (can_travel) {
             if (terrain_usage == TERRAIN_USAGE_WALLS) {
                 path_length = map_routing_get_path(data.direction_paths[path_id], tile_x, tile_y, destination_x, destination_y, 4);
@@ -97,6 +227,10 @@ void figure::figure_route_add() {
                 path_length = map_routing_get_path(data.direction_paths[path_id], tile_x, tile_y, destination_x, destination_y, 8);
         } else // cannot travel
             path_length = 0;
+        if (path_length > 0 && (terrain_usage != TERRAIN_USAGE_PREFER_ROADS || path_from_roads) &&
+            is_cacheable_usage(terrain_usage)) {
+            cache_store(src_offset, dst_offset, terrain_usage, path_id, path_length);
+        }
     }
     if (path_length) {
         data.figure_ids[path_id] = id;
@@ -122,6 +256,7 @@ void figure_route_save_state(buffer *figures, buffer *paths) {
     }
 }
 void figure_route_load_state(buffer *figures, buffer *paths) {
+    cache_clear();
     for (int i = 0; i < MAX_ROUTES; i++) {
         if (!figures->is_valid(2))
             return;
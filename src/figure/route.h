@@ -10,6 +10,15 @@ void figure_route_clean(void);
 //void route_remove();
 int figure_route_get_direction(int path_id, int index);
 
+/**
+ * Number of road and wall routes that were served from the path cache
+ */
+int figure_route_cache_hits(void);
+/**
+ * Number of road and wall routes that had to be searched
+ */
+int figure_route_cache_misses(void);
+
 void figure_route_save_state(buffer *figures, buffer *paths);
 void figure_route_load_state(buffer *figures, buffer *paths);
 
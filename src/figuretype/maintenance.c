@@ -1,6 +1,7 @@
 #include "maintenance.h"
 
 #include "building/building.h"
+#include "building/count.h"
 #include "building/list.h"
 #include "building/maintenance.h"
 #include "city/figures.h"
@@ -560,6 +561,7 @@ void figure::worker_action() {
             if (do_gotobuilding(destination_building_id)) {
                 if (building_is_farm(b_dest->type)) {
                     b_dest->num_workers = 10;
+                    building_count_refresh(b_dest);
                     b_dest->data.industry.worker_id = 0;
                     b_dest->data.industry.labor_state = 2;
                     b_dest->data.industry.labor_days_left = 96;
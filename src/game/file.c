@@ -363,6 +363,12 @@ int game_file_load_saved_game(const char *filename) {
 int game_file_write_saved_game(const char *filename) {
     return game_file_io_write_saved_game(filename);
 }
+int game_file_write_saved_game_in_background(const char *filename) {
+    return game_file_io_write_saved_game_in_background(filename);
+}
+void game_file_wait_for_background_save(void) {
+    game_file_io_wait_for_background_save();
+}
 int game_file_delete_saved_game(const char *filename) {
     return game_file_io_delete_saved_game(filename);
 }
@@ -38,6 +38,19 @@ int game_file_load_saved_game(const char *filename);
  */
 int game_file_write_saved_game(const char *filename);
 
+/**
+ * Write saved game to disk on a background thread, after taking a snapshot of the game state.
+ * Nothing is written while a previous background save is still running.
+ * @param filename File to save to
+ * @return Boolean true if the save was started, false if a previous one is still running
+ */
+int game_file_write_saved_game_in_background(const char *filename);
+
+/**
+ * Wait until the background save, if any, is written
+ */
+void game_file_wait_for_background_save(void);
+
 /**
  * Delete saved game
  * @param filename File to delete
@@ -14,6 +14,7 @@
 #include "city/view.h"
 #include "core/dir.h"
 #include "core/random.h"
+#include "core/thread_pool.h"
 #include "core/zip.h"
 #include "empire/city.h"
 #include "empire/empire.h"
@@ -50,6 +51,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <city/floods.h>
+#include <vector>
+
+#if !defined(__vita__) && !defined(__SWITCH__)
+#include <atomic>
+#include <thread>
+#define HAS_BACKGROUND_SAVE 1
+#else
+#define HAS_BACKGROUND_SAVE 0
+#endif
 
 #define COMPRESS_BUFFER_SIZE 3000000
 #define UNCOMPRESSED 0x80000000
@@ -888,76 +898,115 @@ void log_hex(file_piece *piece, int i, int offs) {
     SDL_Log("Piece %s %03i/%i : %8i@ %-36s(%i) %s", piece->compressed ? "(C)" : "---", i + 1, savegame_data.num_pieces,
             offs, hexstr, piece->buf->size(), fname);
 }
-static int read_compressed_chunk(FILE *fp, buffer *buf, int filepiece_size) {
-    // check that the stream size isn't above maximum temp buffer
-    if (filepiece_size > COMPRESS_BUFFER_SIZE)
-        return 0;
-
-    // read 32-bit int header denoting size of compressed chunk
-    uint32_t chunk_size = 0;
-    fread(&chunk_size, 4, 1, fp);
-
-    // if file signature says "uncompressed" well man, it's uncompressed. read as normal ignoring the directive
-    if ((unsigned int) chunk_size == UNCOMPRESSED) {
-        if (buf->from_file(filepiece_size, fp) != filepiece_size)
-            return 0;
-    } else {
-        // read into buffer chunk of specified size - the actual "file piece" size is used for the output!
-        if (fread(compress_buffer, 1, chunk_size, fp) != chunk_size
-            || zip_decompress(compress_buffer, chunk_size, buf->data_unsafe_pls_use_carefully(), &filepiece_size) !=
-               buf->size())
-            return 0;
-    }
-//    buf->force_validate_unsafe_pls_use_carefully();
+static void dump_piece(buffer *buf, int filepiece_size) {
     char *lfile = (char *) malloc(200);
     sprintf(lfile, "DEV_TESTING/zip/%i_%i_%s", findex, filepiece_size, fname);
     FILE *log = fopen(lfile, "wb+");
     if (log) {
         fwrite(buf->get_data(), filepiece_size, 1, log);
+        fclose(log);
     }
-    fclose(log);
     free(lfile);
-    return 1;
 }
-static int write_compressed_chunk(FILE *fp, buffer *buf, int bytes_to_write) {
+static int write_compressed_chunk(FILE *fp, const uint8_t *data, int bytes_to_write, char *output) {
     if (bytes_to_write > COMPRESS_BUFFER_SIZE)
         return 0;
 
     int output_size = COMPRESS_BUFFER_SIZE;
-    if (zip_compress(buf->get_data(), bytes_to_write, compress_buffer, &output_size)) {
+    if (zip_compress(data, bytes_to_write, output, &output_size, ZIP_LEVEL_DEFAULT)) {
 //        write_int32(fp, output_size);
         fwrite(&output_size, 4, 1, fp);
-        fwrite(compress_buffer, 1, output_size, fp);
+        fwrite(output, 1, output_size, fp);
     } else {
         // unable to compress: write uncompressed
 //        write_int32(fp, UNCOMPRESSED);
         output_size = UNCOMPRESSED;
         fwrite(&output_size, 4, 1, fp);
-        fwrite(buf->get_data(), 1, bytes_to_write, fp);
+        fwrite(data, 1, bytes_to_write, fp);
     }
     return 1;
 }
+// where a piece is stored in the file contents
+typedef struct {
+    int offset;
+    const uint8_t *compressed_data;
+    int compressed_size;
+    int result;
+} piece_location;
+
+static piece_location piece_locations[200];
+
+static void decompress_piece(int index, void *userdata) {
+    piece_location *location = &piece_locations[index];
+    if (!location->compressed_data)
+        return;
+    buffer *buf = savegame_data.pieces[index].buf;
+    int filepiece_size = (int) buf->size();
+    location->result = zip_decompress(location->compressed_data, location->compressed_size,
+                                      buf->data_unsafe_pls_use_carefully(), &filepiece_size) == buf->size();
+}
 static int savegame_read_from_file(FILE *fp) {
+    // read everything at once and find where each piece starts
+    long start = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp) - start;
+    fseek(fp, start, SEEK_SET);
+    if (file_size <= 0)
+        return 0;
+    uint8_t *contents = (uint8_t *) malloc((size_t) file_size);
+    if (!contents)
+        return 0;
+    int contents_size = (int) fread(contents, 1, (size_t) file_size, fp);
+
+    int offset = 0;
     for (int i = 0; i < savegame_data.num_pieces; i++) {
         file_piece *piece = &savegame_data.pieces[i];
-        findex = i;
-        fname = piece->name;
-        int result = 0;
-
-        auto offs = ftell(fp);
+        piece_location *location = &piece_locations[i];
+        int piece_size = (int) piece->buf->size();
+        location->offset = (int) start + offset;
+        location->compressed_data = 0;
+        location->result = 0;
+
+        uint32_t chunk_size = UNCOMPRESSED;
+        if (piece->compressed) {
+            // check that the stream size isn't above maximum temp buffer
+            if (piece_size > COMPRESS_BUFFER_SIZE || offset + 4 > contents_size)
+                continue;
+            // read 32-bit int header denoting size of compressed chunk
+            memcpy(&chunk_size, &contents[offset], 4);
+            offset += 4;
+        }
+        if (chunk_size == UNCOMPRESSED) {
+            // if file signature says "uncompressed" well man, it's uncompressed. read as normal ignoring the directive
+            int available = contents_size - offset < piece_size ? contents_size - offset : piece_size;
+            if (available > 0)
+                memcpy(piece->buf->data_unsafe_pls_use_carefully(), &contents[offset], (size_t) available);
+            location->result = available == piece_size;
+            offset += available > 0 ? available : 0;
+        } else if (chunk_size <= COMPRESS_BUFFER_SIZE && offset + (int) chunk_size <= contents_size) {
+            // the actual "file piece" size is used for the output!
+            location->compressed_data = &contents[offset];
+            location->compressed_size = (int) chunk_size;
+            offset += (int) chunk_size;
+        } else
+            offset = contents_size;
+    }
 
-        if (i == 49)
-            int a = 24;
+    // the pieces are independent, so they are decompressed at the same time
+    thread_pool_run(savegame_data.num_pieces, decompress_piece, 0);
+    free(contents);
 
-        if (piece->compressed)
-            result = read_compressed_chunk(fp, piece->buf, piece->buf->size());
-        else
-            result = piece->buf->from_file(piece->buf->size(), fp) == piece->buf->size();
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        file_piece *piece = &savegame_data.pieces[i];
+        findex = i;
+        fname = piece->name;
+        if (piece->compressed && piece_locations[i].result)
+            dump_piece(piece->buf, (int) piece->buf->size());
 
-        log_hex(piece, i, offs);
+        log_hex(piece, i, piece_locations[i].offset);
 
         // The last piece may be smaller than buf->size
-        if (!result && i != (savegame_data.num_pieces - 1)) {
+        if (!piece_locations[i].result && i != (savegame_data.num_pieces - 1)) {
             log_info("Incorrect buffer size, expected.", 0, piece->buf->size());
             return 0;
         }
@@ -968,7 +1017,7 @@ static void savegame_write_to_file(FILE *fp) {
     for (int i = 0; i < savegame_data.num_pieces; i++) {
         file_piece *piece = &savegame_data.pieces[i];
         if (piece->compressed)
-            write_compressed_chunk(fp, piece->buf, piece->buf->size());
+            write_compressed_chunk(fp, piece->buf->get_data(), piece->buf->size(), compress_buffer);
         else
             piece->buf->to_file(piece->buf->size(), fp);
     }
@@ -1033,6 +1082,13 @@ int game_file_io_read_saved_game(const char *filename, int offset) {
 
 
     int result = savegame_read_from_file(fp);
+    if (!result && !file_has_extension(filename, "pak")) {
+        // classic Caesar 3 saves have the smaller figure, route and building tables
+        log_info("Loading saved game (classic).", filename, 0);
+        init_savegame_data(0);
+        fseek(fp, offset, SEEK_SET);
+        result = savegame_read_from_file(fp);
+    }
     file_close(fp);
     if (!result) {
         log_error("Unable to load game, unable to read savefile.", 0, 0);
@@ -1057,6 +1113,96 @@ int game_file_io_write_saved_game(const char *filename) {
     file_close(fp);
     return 1;
 }
+
+// a copy of the saved game pieces, compressed and written by a background thread
+static struct {
+    std::vector<uint8_t> contents;
+    int num_pieces;
+    int sizes[200];
+    int compressed[200];
+    char filename[FILE_NAME_MAX];
+#if HAS_BACKGROUND_SAVE
+    std::thread thread;
+    std::atomic<int> is_running;
+#endif
+} background_save;
+
+static void write_background_save(void) {
+    char *output = (char *) malloc(COMPRESS_BUFFER_SIZE);
+    char temp_filename[FILE_NAME_MAX + 4]; // the filename plus ".tmp"
+    snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", background_save.filename);
+    FILE *fp = output ? file_open(temp_filename, "wb") : 0;
+    if (fp) {
+        const uint8_t *data = background_save.contents.data();
+        for (int i = 0; i < background_save.num_pieces; i++) {
+            int size = background_save.sizes[i];
+            if (background_save.compressed[i])
+                write_compressed_chunk(fp, data, size, output);
+            else
+                fwrite(data, 1, size, fp);
+            data += size;
+        }
+        int ok = !ferror(fp);
+        if (file_close(fp) != 0)
+            ok = 0;
+        // replace the previous file only when the new one is complete
+        if (!ok || !file_rename(temp_filename, background_save.filename)) {
+            log_error("Unable to save game", background_save.filename, 0);
+            file_remove(temp_filename);
+        }
+    } else
+        log_error("Unable to save game", background_save.filename, 0);
+    free(output);
+#if HAS_BACKGROUND_SAVE
+    background_save.is_running = 0;
+#endif
+}
+int game_file_io_write_saved_game_in_background(const char *filename) {
+#if HAS_BACKGROUND_SAVE
+    if (background_save.is_running) {
+        log_info("Previous save still in progress, skipping", filename, 0);
+        return 0;
+    }
+    if (background_save.thread.joinable())
+        background_save.thread.join();
+#endif
+    init_savegame_data(1);
+
+    log_info("Saving game in background", filename, 0);
+    savegame_save_to_state(&savegame_data.state);
+
+    // take a snapshot, so the game can carry on while the pieces are compressed
+    size_t total_size = 0;
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        total_size += savegame_data.pieces[i].buf->size();
+    }
+    background_save.contents.resize(total_size);
+    uint8_t *data = background_save.contents.data();
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        buffer *buf = savegame_data.pieces[i].buf;
+        memcpy(data, buf->get_data(), buf->size());
+        data += buf->size();
+        background_save.sizes[i] = (int) buf->size();
+        background_save.compressed[i] = savegame_data.pieces[i].compressed;
+    }
+    background_save.num_pieces = savegame_data.num_pieces;
+    strncpy(background_save.filename, filename, FILE_NAME_MAX - 1);
+    background_save.filename[FILE_NAME_MAX - 1] = 0;
+
+#if HAS_BACKGROUND_SAVE
+    background_save.is_running = 1;
+    background_save.thread = std::thread(write_background_save);
+#else
+    write_background_save();
+#endif
+    return 1;
+}
+void game_file_io_wait_for_background_save(void) {
+#if HAS_BACKGROUND_SAVE
+    if (background_save.thread.joinable())
+        background_save.thread.join();
+#endif
+}
 int game_file_io_delete_saved_game(const char *filename) {
     log_info("Deleting game", filename, 0);
     int result = file_remove(filename);
@@ -9,6 +9,7 @@
 #include "core/locale.h"
 #include "core/log.h"
 #include "core/mods.h"
+#include "core/profiler.h"
 #include "core/random.h"
 #include "core/time.h"
 #include "editor/editor.h"
@@ -29,6 +30,7 @@
 #include "sound/city.h"
 #include "sound/system.h"
 #include "translation/translation.h"
+#include "widget/profiler.h"
 #include "window/editor/map.h"
 #include "window/logo.h"
 #include "window/main_menu.h"
@@ -221,6 +223,7 @@ int game_reload_language(void) {
     return reload_language(0, 1);
 }
 void game_run(void) {
+    PROFILE_SCOPE(PROFILER_GAME_RUN);
     game_animation_update();
     int num_ticks = get_elapsed_ticks();
     for (int i = 0; i < num_ticks; i++) {
@@ -232,10 +235,17 @@ void game_run(void) {
     }
 }
 void game_draw(void) {
-    window_draw(0);
-    sound_city_play();
+    {
+        PROFILE_SCOPE(PROFILER_GAME_DRAW);
+        window_draw(0);
+        sound_city_play();
+    }
+    image_trim_lazy_data();
+    widget_profiler_draw();
+    profiler_end_frame();
 }
 void game_exit(void) {
+    game_file_wait_for_background_save();
     video_shutdown();
     settings_save();
     config_save();
@@ -11,6 +11,7 @@
 #include "building/house_service.h"
 #include "building/industry.h"
 #include "building/maintenance.h"
+#include "building/sweep.h"
 #include "building/warehouse.h"
 #include "city/culture.h"
 #include "city/emperor.h"
@@ -27,6 +28,7 @@
 #include "city/sentiment.h"
 #include "city/trade.h"
 #include "city/victory.h"
+#include "core/profiler.h"
 #include "core/random.h"
 #include "editor/editor.h"
 #include "empire/city.h"
@@ -34,6 +36,7 @@
 #include "figuretype/crime.h"
 #include "game/file.h"
 #include "game/settings.h"
+#include "game/tick_jobs.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "game/undo.h"
@@ -100,7 +103,7 @@ static void advance_month(void) {
     city_festival_update();
     tutorial_on_month_tick();
     if (setting_monthly_autosave())
-        game_file_write_saved_game("autosave.svx");
+        game_file_write_saved_game_in_background("autosave.svx");
 
 }
 
@@ -116,15 +119,58 @@ static void advance_day(void) {
     tutorial_on_day_tick();
 }
 
+// Stages whose data use has been checked, so tick_jobs_run may overlap them.
+// The floodplains run every tick, before the stage of the tick slot.
+static const tick_job FLOODPLAINS_JOB = {
+        "floodplains", floodplains_tick_update,
+        TICK_DATA_BUILDINGS | TICK_DATA_TERRAIN | TICK_DATA_RANDOM | TICK_DATA_FLOODPLAIN,
+        TICK_DATA_TERRAIN | TICK_DATA_RANDOM | TICK_DATA_FLOODPLAIN
+};
+static const struct {
+    int tick;
+    tick_job job;
+} SLOT_JOBS[] = {
+        {7, {"road network", map_road_network_update,
+             TICK_DATA_TERRAIN,
+             TICK_DATA_ROAD_NETWORK | TICK_DATA_CITY}},
+        {28, {"house water access", map_water_supply_update_houses,
+              TICK_DATA_BUILDINGS | TICK_DATA_TERRAIN,
+              TICK_DATA_BUILDINGS}},
+        {37, {"desirability", map_desirability_update,
+              TICK_DATA_BUILDINGS | TICK_DATA_TERRAIN | TICK_DATA_DESIRABILITY,
+              TICK_DATA_TERRAIN | TICK_DATA_DESIRABILITY}},
+        {49, {"culture", city_culture_calculate,
+              TICK_DATA_BUILDINGS | TICK_DATA_CITY,
+              TICK_DATA_CITY}},
+};
+
+int game_tick_get_jobs(int tick, tick_job *jobs) {
+    int num_jobs = 0;
+    if (GAME_ENV == ENGINE_ENV_PHARAOH)
+        jobs[num_jobs++] = FLOODPLAINS_JOB;
+    int num_slot_jobs = sizeof(SLOT_JOBS) / sizeof(SLOT_JOBS[0]);
+    for (int i = 0; i < num_slot_jobs && num_jobs < MAX_TICK_JOBS; i++) {
+        if (SLOT_JOBS[i].tick == tick)
+            jobs[num_jobs++] = SLOT_JOBS[i].job;
+    }
+    return num_jobs;
+}
+static void run_tick_jobs(int tick) {
+    tick_job jobs[MAX_TICK_JOBS];
+    tick_jobs_run(jobs, game_tick_get_jobs(tick, jobs));
+}
+
 static void advance_tick(void) {
+    PROFILE_SCOPE(PROFILER_TICK_SLOT, game_time_tick());
 
     tutorial_starting_message();
 
-    if (GAME_ENV == ENGINE_ENV_PHARAOH)
-        floodplains_tick_update();
+    run_tick_jobs(game_time_tick());
 
     // NB: these ticks are noop:
     // 0, 9, 11, 13, 14, 15, 26, 41, 42, 47
+    // and these only run SLOT_JOBS:
+    // 7, 28, 37, 49
 
     switch (game_time_tick()) {
         case 1:
@@ -145,9 +191,6 @@ static void advance_tick(void) {
         case 6:
             map_natives_check_land();
             break;
-        case 7:
-            map_road_network_update();
-            break;
         case 8:
             building_granaries_calculate_stocks();
             break;
@@ -193,9 +236,6 @@ static void advance_tick(void) {
             else if (GAME_ENV == ENGINE_ENV_PHARAOH)
                 map_water_supply_update_wells_PH();
             break;
-        case 28:
-            map_water_supply_update_houses();
-            break;
         case 29:
             formation_update_all(1);
             break;
@@ -208,11 +248,13 @@ static void advance_tick(void) {
         case 32:
             city_trade_update();
             break;
-        case 33:
-            building_count_update();
-            building_entertainment_update();
+        case 33: {
+            // both only touch the building they visit, so they share one pass
+            building_sweep_job jobs[] = {building_count_update_job(), building_entertainment_update_job()};
+            building_sweep_run(jobs, 2);
             city_culture_update_coverage();
             break;
+        }
         case 34:
             building_government_distribute_treasury();
             break;
@@ -222,9 +264,6 @@ static void advance_tick(void) {
         case 36:
             house_service_calculate_culture_aggregates();
             break;
-        case 37:
-            map_desirability_update();
-            break;
         case 38:
             building_update_desirability();
             break;
@@ -249,9 +288,6 @@ static void advance_tick(void) {
         case 48:
             house_service_decay_tax_collector();
             break;
-        case 49:
-            city_culture_calculate();
-            break;
         case 50:
             // todo
 //            flood message prediction
@@ -1,8 +1,20 @@
 #ifndef GAME_TICK_H
 #define GAME_TICK_H
 
+#include "game/tick_jobs.h"
+
+#define MAX_TICK_JOBS 4
+
 void game_tick_run(void);
 
 void game_tick_cheat_year(void);
 
+/**
+ * Gets the checked stages that start a tick slot, in the order they run
+ * @param tick Tick slot
+ * @param jobs Gets the jobs, room for MAX_TICK_JOBS
+ * @return Number of jobs
+ */
+int game_tick_get_jobs(int tick, tick_job *jobs);
+
 #endif // GAME_TICK_H
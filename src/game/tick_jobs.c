@@ -0,0 +1,39 @@
+#include "tick_jobs.h"
+
+#include "core/thread_pool.h"
+
+#define MAX_JOBS_PER_WAVE 8
+
+static int conflict(const tick_job *a, const tick_job *b) {
+    return (a->writes & (b->reads | b->writes)) || (b->writes & a->reads);
+}
+
+static void run_wave_job(int index, void *userdata) {
+    const tick_job *wave = (const tick_job *) userdata;
+    wave[index].run();
+}
+
+int tick_jobs_wave_size(const tick_job *jobs, int num_jobs) {
+    // a wave only ever takes the next job in order, so no job is moved past one it conflicts with
+    int wave_size = 0;
+    while (wave_size < num_jobs && wave_size < MAX_JOBS_PER_WAVE) {
+        for (int w = 0; w < wave_size; w++) {
+            if (conflict(&jobs[w], &jobs[wave_size]))
+                return wave_size;
+        }
+        wave_size++;
+    }
+    return wave_size;
+}
+
+void tick_jobs_run(const tick_job *jobs, int num_jobs) {
+    int start = 0;
+    while (start < num_jobs) {
+        int wave_size = tick_jobs_wave_size(&jobs[start], num_jobs - start);
+        if (wave_size == 1)
+            jobs[start].run();
+        else
+            thread_pool_run(wave_size, run_wave_job, (void *) &jobs[start]);
+        start += wave_size;
+    }
+}
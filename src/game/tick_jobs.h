@@ -0,0 +1,55 @@
+#ifndef GAME_TICK_JOBS_H
+#define GAME_TICK_JOBS_H
+
+/**
+ * @file
+ * Runs simulation stages that declare which game data they read and write.
+ *
+ * Consecutive jobs run at the same time when none of them writes data that another one reads or
+ * writes, so the result is the same as running them one after another in the given order.
+ */
+
+enum {
+    /** Building records, building counts and building lists */
+    TICK_DATA_BUILDINGS = 1 << 0,
+    /** Terrain, image, building, property and other tile grids */
+    TICK_DATA_TERRAIN = 1 << 1,
+    /** State of the random generator */
+    TICK_DATA_RANDOM = 1 << 2,
+    /** Flood cycle of the floodplains */
+    TICK_DATA_FLOODPLAIN = 1 << 3,
+    /** Road network grid */
+    TICK_DATA_ROAD_NETWORK = 1 << 4,
+    /** Desirability grid */
+    TICK_DATA_DESIRABILITY = 1 << 5,
+    /** City-wide aggregates: population, resources, coverage, ratings and so on */
+    TICK_DATA_CITY = 1 << 6,
+    /** Everything, for stages nobody has checked */
+    TICK_DATA_ALL = ~0
+};
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+    /** TICK_DATA_ flags of the data the job reads */
+    int reads;
+    /** TICK_DATA_ flags of the data the job changes */
+    int writes;
+} tick_job;
+
+/**
+ * Gets the size of the first wave: the jobs, from the first one on, that run at the same time
+ * @param jobs Jobs in the order they would run one after another
+ * @param num_jobs Number of jobs
+ * @return Number of jobs in the wave, 0 if there are no jobs
+ */
+int tick_jobs_wave_size(const tick_job *jobs, int num_jobs);
+
+/**
+ * Runs the jobs, the ones that don't conflict with each other on several threads
+ * @param jobs Jobs in the order they would run one after another
+ * @param num_jobs Number of jobs
+ */
+void tick_jobs_run(const tick_job *jobs, int num_jobs);
+
+#endif // GAME_TICK_JOBS_H
@@ -1,5 +1,6 @@
 #include "undo.h"
 
+#include "building/count.h"
 #include "building/industry.h"
 #include "building/properties.h"
 #include "building/storage.h"
@@ -119,8 +120,10 @@ void game_undo_restore_building_state(void) {
     for (int i = 0; i < data.num_buildings; i++) {
         if (data.buildings[i].id) {
             building *b = building_get(data.buildings[i].id);
-            if (b->state == BUILDING_STATE_DELETED_BY_PLAYER)
+            if (b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
                 b->state = BUILDING_STATE_VALID;
+                building_count_refresh(b);
+            }
             b->is_deleted = 0;
         }
     }
@@ -130,12 +133,25 @@ void game_undo_restore_building_state(void) {
 static void restore_map_images(void) {
     int map_width, map_height;
     map_grid_size(&map_width, &map_height);
-    for (int y = 0; y < map_height; y++) {
-        for (int x = 0; x < map_width; x++) {
-            int grid_offset = map_grid_offset(x, y);
-            if (!map_building_at(grid_offset))
-                map_image_restore_at(grid_offset);
+    const int *offsets;
+    int num_offsets = map_image_changes_since_backup(&offsets);
+    if (num_offsets < 0) {
+        for (int y = 0; y < map_height; y++) {
+            for (int x = 0; x < map_width; x++) {
+                int grid_offset = map_grid_offset(x, y);
+                if (!map_building_at(grid_offset))
+                    map_image_restore_at(grid_offset);
+            }
         }
+        return;
+    }
+    // only the tiles written since the build started can differ from the backup
+    for (int i = 0; i < num_offsets; i++) {
+        int grid_offset = offsets[i];
+        int x = map_grid_offset_to_x(grid_offset);
+        int y = map_grid_offset_to_y(grid_offset);
+        if (x >= 0 && x < map_width && y >= 0 && y < map_height && !map_building_at(grid_offset))
+            map_image_restore_at(grid_offset);
     }
 }
 
@@ -190,6 +206,7 @@ static void add_building_to_terrain(building *b) {
             b->data.industry.fishing_boat_id = 0;
     }
     b->state = BUILDING_STATE_VALID;
+    building_count_refresh(b);
 
     while (b->prev_part_building_id)
         b = building_get(b->prev_part_building_id);
@@ -255,6 +272,7 @@ void game_undo_perform(void) {
                     restore_housing(&data.buildings[i]);
                 else {
                     memcpy(b, &data.buildings[i], sizeof(building));
+                    building_update_type_index(b);
                     if (b->type == BUILDING_WAREHOUSE || b->type == BUILDING_GRANARY) {
                         if (!building_storage_restore(b->storage_id))
                             building_storage_reset_building_ids();
@@ -297,6 +315,7 @@ void game_undo_perform(void) {
                     building_warehouses_add_resource(RESOURCE_MARBLE_C3, 2);
 
                 b->state = BUILDING_STATE_UNDO;
+                building_count_refresh(b);
             }
         }
     }
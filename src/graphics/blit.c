@@ -0,0 +1,333 @@
+#include "blit.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIT_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define BLIT_AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define BLIT_AVX2
+#define TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define BLIT_NEON
+#include <arm_neon.h>
+#endif
+
+#define MAX_BLIT_FUNCTIONS 4
+
+// Reference versions: every other kernel must produce exactly the same pixels
+
+static void copy_scalar(color_t *dst, const color_t *src, int num_pixels) {
+    memcpy(dst, src, num_pixels * sizeof(color_t));
+}
+
+static void copy_mirrored_scalar(color_t *dst, const color_t *src, int num_pixels) {
+    for (int i = 0; i < num_pixels; i++)
+        dst[i] = src[num_pixels - 1 - i];
+}
+
+static void fill_scalar(color_t *dst, color_t color, int num_pixels) {
+    for (int i = 0; i < num_pixels; i++)
+        dst[i] = color;
+}
+
+static void and_src_scalar(color_t *dst, const color_t *src, color_t mask, int num_pixels) {
+    for (int i = 0; i < num_pixels; i++)
+        dst[i] = src[i] & mask;
+}
+
+static void and_dst_scalar(color_t *dst, color_t mask, int num_pixels) {
+    for (int i = 0; i < num_pixels; i++)
+        dst[i] &= mask;
+}
+
+static void blend_alpha_scalar(color_t *dst, color_t color, int num_pixels) {
+    color_t alpha = COLOR_COMPONENT(color, COLOR_BITSHIFT_ALPHA);
+    color_t alpha_dst = 256 - alpha;
+    color_t src_rb = (color & 0xff00ff) * alpha;
+    color_t src_g = (color & 0x00ff00) * alpha;
+    for (int i = 0; i < num_pixels; i++) {
+        color_t d = dst[i];
+        dst[i] = (((src_rb + (d & 0xff00ff) * alpha_dst) & 0xff00ff00) |
+                  ((src_g + (d & 0x00ff00) * alpha_dst) & 0x00ff0000)) >> 8;
+    }
+}
+
+static const blit_functions SCALAR = {
+        "scalar",
+        copy_scalar,
+        copy_mirrored_scalar,
+        fill_scalar,
+        and_src_scalar,
+        and_dst_scalar,
+        blend_alpha_scalar
+};
+
+// The blend works on 16-bit channels: source * alpha + destination * (256 - alpha) never exceeds 255 * 256,
+// so shifting each channel right by 8 gives the same result as the scalar version. The alpha channel ends up 0.
+
+#ifdef BLIT_SSE2
+
+static void copy_mirrored_sse2(color_t *dst, const color_t *src, int num_pixels) {
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i *) (src + num_pixels - 4 - i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 1, 2, 3)));
+    }
+    copy_mirrored_scalar(dst + i, src, num_pixels - i);
+}
+
+static void fill_sse2(color_t *dst, color_t color, int num_pixels) {
+    __m128i value = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4)
+        _mm_storeu_si128((__m128i *) (dst + i), value);
+    fill_scalar(dst + i, color, num_pixels - i);
+}
+
+static void and_src_sse2(color_t *dst, const color_t *src, color_t mask, int num_pixels) {
+    __m128i value = _mm_set1_epi32((int) mask);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_and_si128(pixels, value));
+    }
+    and_src_scalar(dst + i, src + i, mask, num_pixels - i);
+}
+
+static void and_dst_sse2(color_t *dst, color_t mask, int num_pixels) {
+    __m128i value = _mm_set1_epi32((int) mask);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i *) (dst + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_and_si128(pixels, value));
+    }
+    and_dst_scalar(dst + i, mask, num_pixels - i);
+}
+
+static void blend_alpha_sse2(color_t *dst, color_t color, int num_pixels) {
+    int alpha = COLOR_COMPONENT(color, COLOR_BITSHIFT_ALPHA);
+    short src_r = (short) (COLOR_COMPONENT(color, 16) * alpha);
+    short src_g = (short) (COLOR_COMPONENT(color, 8) * alpha);
+    short src_b = (short) (COLOR_COMPONENT(color, 0) * alpha);
+    __m128i src = _mm_set_epi16(0, src_r, src_g, src_b, 0, src_r, src_g, src_b);
+    __m128i alpha_dst = _mm_set1_epi16((short) (256 - alpha));
+    __m128i rgb_mask = _mm_set1_epi32(0x00ffffff);
+    __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i *) (dst + i));
+        __m128i lo = _mm_add_epi16(src, _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), alpha_dst));
+        __m128i hi = _mm_add_epi16(src, _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), alpha_dst));
+        __m128i result = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_and_si128(result, rgb_mask));
+    }
+    blend_alpha_scalar(dst + i, color, num_pixels - i);
+}
+
+static const blit_functions SSE2 = {
+        "sse2",
+        copy_scalar,
+        copy_mirrored_sse2,
+        fill_sse2,
+        and_src_sse2,
+        and_dst_sse2,
+        blend_alpha_sse2
+};
+
+#endif // BLIT_SSE2
+
+#ifdef BLIT_AVX2
+
+TARGET_AVX2 static void fill_avx2(color_t *dst, color_t color, int num_pixels) {
+    __m256i value = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8)
+        _mm256_storeu_si256((__m256i *) (dst + i), value);
+    fill_sse2(dst + i, color, num_pixels - i);
+}
+
+TARGET_AVX2 static void and_src_avx2(color_t *dst, const color_t *src, color_t mask, int num_pixels) {
+    __m256i value = _mm256_set1_epi32((int) mask);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i *) (src + i));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_and_si256(pixels, value));
+    }
+    and_src_sse2(dst + i, src + i, mask, num_pixels - i);
+}
+
+TARGET_AVX2 static void and_dst_avx2(color_t *dst, color_t mask, int num_pixels) {
+    __m256i value = _mm256_set1_epi32((int) mask);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i *) (dst + i));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_and_si256(pixels, value));
+    }
+    and_dst_sse2(dst + i, mask, num_pixels - i);
+}
+
+TARGET_AVX2 static void blend_alpha_avx2(color_t *dst, color_t color, int num_pixels) {
+    int alpha = COLOR_COMPONENT(color, COLOR_BITSHIFT_ALPHA);
+    short src_r = (short) (COLOR_COMPONENT(color, 16) * alpha);
+    short src_g = (short) (COLOR_COMPONENT(color, 8) * alpha);
+    short src_b = (short) (COLOR_COMPONENT(color, 0) * alpha);
+    __m256i src = _mm256_set_epi16(0, src_r, src_g, src_b, 0, src_r, src_g, src_b,
+                                   0, src_r, src_g, src_b, 0, src_r, src_g, src_b);
+    __m256i alpha_dst = _mm256_set1_epi16((short) (256 - alpha));
+    __m256i rgb_mask = _mm256_set1_epi32(0x00ffffff);
+    __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i *) (dst + i));
+        __m256i lo = _mm256_add_epi16(src, _mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), alpha_dst));
+        __m256i hi = _mm256_add_epi16(src, _mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), alpha_dst));
+        __m256i result = _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_and_si256(result, rgb_mask));
+    }
+    blend_alpha_sse2(dst + i, color, num_pixels - i);
+}
+
+static const blit_functions AVX2 = {
+        "avx2",
+        copy_scalar,
+        copy_mirrored_sse2,
+        fill_avx2,
+        and_src_avx2,
+        and_dst_avx2,
+        blend_alpha_avx2
+};
+
+static int cpu_has_avx2(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return 0;
+    __cpuid(info, 1);
+    // the OS has to save the AVX registers
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+        return 0;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // BLIT_AVX2
+
+#ifdef BLIT_NEON
+
+static void copy_mirrored_neon(color_t *dst, const color_t *src, int num_pixels) {
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint32x4_t pixels = vld1q_u32(src + num_pixels - 4 - i);
+        pixels = vrev64q_u32(pixels);
+        vst1q_u32(dst + i, vcombine_u32(vget_high_u32(pixels), vget_low_u32(pixels)));
+    }
+    copy_mirrored_scalar(dst + i, src, num_pixels - i);
+}
+
+static void fill_neon(color_t *dst, color_t color, int num_pixels) {
+    uint32x4_t value = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4)
+        vst1q_u32(dst + i, value);
+    fill_scalar(dst + i, color, num_pixels - i);
+}
+
+static void and_src_neon(color_t *dst, const color_t *src, color_t mask, int num_pixels) {
+    uint32x4_t value = vdupq_n_u32(mask);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4)
+        vst1q_u32(dst + i, vandq_u32(vld1q_u32(src + i), value));
+    and_src_scalar(dst + i, src + i, mask, num_pixels - i);
+}
+
+static void and_dst_neon(color_t *dst, color_t mask, int num_pixels) {
+    uint32x4_t value = vdupq_n_u32(mask);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4)
+        vst1q_u32(dst + i, vandq_u32(vld1q_u32(dst + i), value));
+    and_dst_scalar(dst + i, mask, num_pixels - i);
+}
+
+static void blend_alpha_neon(color_t *dst, color_t color, int num_pixels) {
+    int alpha = COLOR_COMPONENT(color, COLOR_BITSHIFT_ALPHA);
+    uint16_t src_r = (uint16_t) (COLOR_COMPONENT(color, 16) * alpha);
+    uint16_t src_g = (uint16_t) (COLOR_COMPONENT(color, 8) * alpha);
+    uint16_t src_b = (uint16_t) (COLOR_COMPONENT(color, 0) * alpha);
+    const uint16_t src_values[8] = {src_b, src_g, src_r, 0, src_b, src_g, src_r, 0};
+    uint16x8_t src = vld1q_u16(src_values);
+    uint8x8_t alpha_dst = vdup_n_u8((uint8_t) (256 - alpha));
+    uint32x4_t rgb_mask = vdupq_n_u32(0x00ffffff);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint8x16_t pixels = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+        uint16x8_t lo = vmlal_u8(src, vget_low_u8(pixels), alpha_dst);
+        uint16x8_t hi = vmlal_u8(src, vget_high_u8(pixels), alpha_dst);
+        uint8x16_t result = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+        vst1q_u32(dst + i, vandq_u32(vreinterpretq_u32_u8(result), rgb_mask));
+    }
+    blend_alpha_scalar(dst + i, color, num_pixels - i);
+}
+
+static const blit_functions NEON = {
+        "neon",
+        copy_scalar,
+        copy_mirrored_neon,
+        fill_neon,
+        and_src_neon,
+        and_dst_neon,
+        blend_alpha_neon
+};
+
+#endif // BLIT_NEON
+
+static struct {
+    const blit_functions *all[MAX_BLIT_FUNCTIONS];
+    int num_functions;
+} data;
+
+static int find_functions(void) {
+    data.all[data.num_functions++] = &SCALAR;
+#ifdef BLIT_SSE2
+    data.all[data.num_functions++] = &SSE2;
+#endif
+#ifdef BLIT_AVX2
+    if (cpu_has_avx2())
+        data.all[data.num_functions++] = &AVX2;
+#endif
+#ifdef BLIT_NEON
+    data.all[data.num_functions++] = &NEON;
+#endif
+    return 1;
+}
+
+static void init_functions(void) {
+    // the city is drawn from several threads: a static local is initialized exactly once
+    static int initialized = find_functions();
+    (void) initialized;
+}
+
+const blit_functions *blit_get(void) {
+    init_functions();
+    return data.all[data.num_functions - 1];
+}
+
+const blit_functions *const *blit_get_all(int *num_functions) {
+    init_functions();
+    *num_functions = data.num_functions;
+    return data.all;
+}
@@ -0,0 +1,41 @@
+#ifndef GRAPHICS_BLIT_H
+#define GRAPHICS_BLIT_H
+
+#include "graphics/color.h"
+
+/**
+ * @file
+ * Span kernels for drawing runs of pixels, with a scalar reference version and
+ * vectorized versions chosen at runtime.
+ */
+
+typedef struct {
+    const char *name;
+    /** dst[i] = src[i] */
+    void (*copy)(color_t *dst, const color_t *src, int num_pixels);
+    /** dst[i] = src[num_pixels - 1 - i] */
+    void (*copy_mirrored)(color_t *dst, const color_t *src, int num_pixels);
+    /** dst[i] = color */
+    void (*fill)(color_t *dst, color_t color, int num_pixels);
+    /** dst[i] = src[i] & mask */
+    void (*and_src)(color_t *dst, const color_t *src, color_t mask, int num_pixels);
+    /** dst[i] &= mask */
+    void (*and_dst)(color_t *dst, color_t mask, int num_pixels);
+    /** Blends color over dst[i] with the alpha of color, which must be between 1 and 254 */
+    void (*blend_alpha)(color_t *dst, color_t color, int num_pixels);
+} blit_functions;
+
+/**
+ * Gets the fastest span kernels the CPU supports
+ * @return Kernels
+ */
+const blit_functions *blit_get(void);
+
+/**
+ * Gets all kernels that are available on this CPU, the scalar reference first
+ * @param num_functions Filled with the number of kernel sets
+ * @return Kernel sets
+ */
+const blit_functions *const *blit_get_all(int *num_functions);
+
+#endif // GRAPHICS_BLIT_H
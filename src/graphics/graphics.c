@@ -14,13 +14,16 @@
 #include <vita2d.h>
 #endif
 
-static struct {
+typedef struct {
     color_t *pixels;
     int width;
     int height;
-} canvas[MAX_CANVAS];
+} canvas_info;
 
-static struct {
+static canvas_info canvas[MAX_CANVAS];
+
+// clipping is per thread, so the city can be drawn in bands on worker threads
+static thread_local struct {
     int x_start;
     int x_end;
     int y_start;
@@ -32,8 +35,65 @@ static struct {
     int y;
 } translation;
 
-static clip_info clip;
-static canvas_type active_canvas;
+static thread_local clip_info clip;
+
+// the active canvas and the custom canvas are per thread too, so worker threads can render into their own buffers
+static thread_local canvas_type active_canvas;
+static thread_local canvas_info custom_canvas;
+
+static canvas_info *get_active_canvas(void) {
+    return active_canvas == CANVAS_CUSTOM ? &custom_canvas : &canvas[active_canvas];
+}
+
+#define DIRTY_CELL_SHIFT 6
+#define DIRTY_CELL_SIZE (1 << DIRTY_CELL_SHIFT)
+
+// changed areas of the UI and city canvas in cells of 64x64 pixels, so the platform only uploads those
+static struct {
+    uint8_t *cells;
+    int columns;
+    int rows;
+    int is_dirty;
+} dirty[MAX_CANVAS];
+
+// only the thread that owns the canvas tracks changes; worker threads drawing into it are covered by that thread
+static thread_local int is_drawing_thread;
+
+static void init_dirty_cells(canvas_type type) {
+    free(dirty[type].cells);
+    dirty[type].columns = (canvas[type].width + DIRTY_CELL_SIZE - 1) >> DIRTY_CELL_SHIFT;
+    dirty[type].rows = (canvas[type].height + DIRTY_CELL_SIZE - 1) >> DIRTY_CELL_SHIFT;
+    dirty[type].cells = (uint8_t *) malloc((size_t) dirty[type].columns * dirty[type].rows);
+    dirty[type].is_dirty = 0;
+}
+
+static void mark_dirty(canvas_type type, int x_min, int y_min, int x_max, int y_max) {
+    if (x_min < 0)
+        x_min = 0;
+    if (y_min < 0)
+        y_min = 0;
+    if (x_max > canvas[type].width)
+        x_max = canvas[type].width;
+    if (y_max > canvas[type].height)
+        y_max = canvas[type].height;
+    if (!dirty[type].cells || x_min >= x_max || y_min >= y_max)
+        return;
+    int column_min = x_min >> DIRTY_CELL_SHIFT;
+    int column_max = (x_max - 1) >> DIRTY_CELL_SHIFT;
+    for (int row = y_min >> DIRTY_CELL_SHIFT; row <= (y_max - 1) >> DIRTY_CELL_SHIFT; row++) {
+        memset(&dirty[type].cells[row * dirty[type].columns + column_min], 1, column_max - column_min + 1);
+    }
+    dirty[type].is_dirty = 1;
+}
+
+static void mark_active_dirty(int x_min, int y_min, int x_max, int y_max) {
+    if (!is_drawing_thread || active_canvas == CANVAS_CUSTOM)
+        return;
+    if (active_canvas == CANVAS_UI)
+        mark_dirty(CANVAS_UI, translation.x + x_min, translation.y + y_min, translation.x + x_max, translation.y + y_max);
+    else
+        mark_dirty(active_canvas, x_min, y_min, x_max, y_max);
+}
 
 #ifdef __vita__
 extern vita2d_texture *tex_buffer_ui;
@@ -62,6 +122,9 @@ void graphics_init_canvas(int width, int height) {
     canvas[CANVAS_UI].height = height;
     canvas[CANVAS_CITY].width = width * 2;
     canvas[CANVAS_CITY].height = height * 2;
+    is_drawing_thread = 1;
+    init_dirty_cells(CANVAS_UI);
+    init_dirty_cells(CANVAS_CITY);
 
     graphics_clear_screens();
     graphics_set_clip_rectangle(0, 0, width, height);
@@ -80,9 +143,9 @@ void graphics_set_active_canvas(canvas_type type) {
 }
 
 void graphics_set_custom_canvas(color_t *pixels, int width, int height) {
-    canvas[CANVAS_CUSTOM].pixels = pixels;
-    canvas[CANVAS_CUSTOM].width = width;
-    canvas[CANVAS_CUSTOM].height = height;
+    custom_canvas.pixels = pixels;
+    custom_canvas.width = width;
+    custom_canvas.height = height;
     graphics_set_active_canvas(CANVAS_CUSTOM);
 }
 
@@ -125,19 +188,26 @@ void graphics_set_clip_rectangle(int x, int y, int width, int height) {
     if (translation.y + clip_rectangle.y_start < 0)
         clip_rectangle.y_start = -translation.y;
 
-    if (translation.x + clip_rectangle.x_end > canvas[active_canvas].width)
-        clip_rectangle.x_end = canvas[active_canvas].width - translation.x;
+    if (translation.x + clip_rectangle.x_end > get_active_canvas()->width)
+        clip_rectangle.x_end = get_active_canvas()->width - translation.x;
 
-    if (translation.y + clip_rectangle.y_end > canvas[active_canvas].height)
-        clip_rectangle.y_end = canvas[active_canvas].height - translation.y;
+    if (translation.y + clip_rectangle.y_end > get_active_canvas()->height)
+        clip_rectangle.y_end = get_active_canvas()->height - translation.y;
 
 }
 
+void graphics_get_clip_rectangle(int *x, int *y, int *width, int *height) {
+    *x = clip_rectangle.x_start;
+    *y = clip_rectangle.y_start;
+    *width = clip_rectangle.x_end - clip_rectangle.x_start;
+    *height = clip_rectangle.y_end - clip_rectangle.y_start;
+}
+
 void graphics_reset_clip_rectangle(void) {
     clip_rectangle.x_start = 0;
-    clip_rectangle.x_end = canvas[active_canvas].width;
+    clip_rectangle.x_end = get_active_canvas()->width;
     clip_rectangle.y_start = 0;
-    clip_rectangle.y_end = canvas[active_canvas].height;
+    clip_rectangle.y_end = get_active_canvas()->height;
     if (active_canvas == CANVAS_UI)
         translate_clip(translation.x, translation.y);
 
@@ -196,7 +266,7 @@ static void set_clip_y(int y_offset, int height) {
     clip.visible_pixels_y = height - clip.clipped_pixels_top - clip.clipped_pixels_bottom;
 }
 
-const clip_info *graphics_get_clip_info(int x, int y, int width, int height, bool mirrored) {
+static const clip_info *calculate_clip(int x, int y, int width, int height, bool mirrored) {
     if (mirrored)
         set_clip_x(clip_rectangle.x_end - x - width, width);
     else
@@ -210,8 +280,83 @@ const clip_info *graphics_get_clip_info(int x, int y, int width, int height, boo
     return &clip;
 }
 
+const clip_info *graphics_get_clip_info(int x, int y, int width, int height, bool mirrored) {
+    calculate_clip(x, y, width, height, mirrored);
+    if (clip.is_visible) {
+        // mirrored images are drawn within the same columns, so the unmirrored clip covers them
+        int x_min = x > clip_rectangle.x_start ? x : clip_rectangle.x_start;
+        int x_max = x + width < clip_rectangle.x_end ? x + width : clip_rectangle.x_end;
+        mark_active_dirty(x_min, y + clip.clipped_pixels_top, x_max, y + height - clip.clipped_pixels_bottom);
+    }
+    return &clip;
+}
+
+void graphics_mark_dirty(int x, int y, int width, int height) {
+    mark_active_dirty(x, y, x + width, y + height);
+}
+
+void graphics_mark_all_dirty(void) {
+    mark_dirty(CANVAS_UI, 0, 0, canvas[CANVAS_UI].width, canvas[CANVAS_UI].height);
+    mark_dirty(CANVAS_CITY, 0, 0, canvas[CANVAS_CITY].width, canvas[CANVAS_CITY].height);
+}
+
+int graphics_take_dirty_rects(canvas_type type, graphics_rect *rects, int max_rects) {
+    if (!dirty[type].is_dirty)
+        return 0;
+    int num_rects = 0;
+    int overflow = 0;
+    // runs of dirty cells in a row extend the rectangle above them when they span the same columns
+    for (int row = 0; row < dirty[type].rows; row++) {
+        const uint8_t *cells = &dirty[type].cells[row * dirty[type].columns];
+        int column = 0;
+        while (column < dirty[type].columns) {
+            if (!cells[column]) {
+                column++;
+                continue;
+            }
+            int start = column;
+            while (column < dirty[type].columns && cells[column]) {
+                column++;
+            }
+            graphics_rect run = {start * DIRTY_CELL_SIZE, row * DIRTY_CELL_SIZE,
+                                 (column - start) * DIRTY_CELL_SIZE, DIRTY_CELL_SIZE};
+            int extended = 0;
+            for (int i = 0; i < num_rects; i++) {
+                graphics_rect *r = &rects[i];
+                if (r->x == run.x && r->width == run.width && r->y + r->height == run.y) {
+                    r->height += DIRTY_CELL_SIZE;
+                    extended = 1;
+                    break;
+                }
+            }
+            if (extended)
+                continue;
+            if (num_rects < max_rects)
+                rects[num_rects++] = run;
+            else
+                overflow = 1;
+        }
+    }
+    memset(dirty[type].cells, 0, (size_t) dirty[type].columns * dirty[type].rows);
+    dirty[type].is_dirty = 0;
+    if (overflow) {
+        rects[0].x = rects[0].y = 0;
+        rects[0].width = canvas[type].width;
+        rects[0].height = canvas[type].height;
+        return 1;
+    }
+    // the last row and column of cells can be partly outside the canvas
+    for (int i = 0; i < num_rects; i++) {
+        if (rects[i].x + rects[i].width > canvas[type].width)
+            rects[i].width = canvas[type].width - rects[i].x;
+        if (rects[i].y + rects[i].height > canvas[type].height)
+            rects[i].height = canvas[type].height - rects[i].y;
+    }
+    return num_rects;
+}
+
 void graphics_save_to_buffer(int x, int y, int width, int height, color_t *buffer) {
-    const clip_info *current_clip = graphics_get_clip_info(x, y, width, height);
+    const clip_info *current_clip = calculate_clip(x, y, width, height, false);
     if (!current_clip->is_visible)
         return;
     int min_x = x + current_clip->clipped_pixels_left;
@@ -240,17 +385,20 @@ color_t *graphics_get_pixel(int x, int y) {
     if (active_canvas == CANVAS_UI)
         return &canvas[CANVAS_UI].pixels[(translation.y + y) * canvas[CANVAS_UI].width + translation.x + x];
     else {
-        return &canvas[active_canvas].pixels[y * canvas[active_canvas].width + x];
+        const canvas_info *current = get_active_canvas();
+        return &current->pixels[y * current->width + x];
     }
 }
 
 void graphics_clear_screen(canvas_type type) {
     memset(canvas[type].pixels, 0, sizeof(color_t) * canvas[type].width * canvas[type].height);
+    mark_dirty(type, 0, 0, canvas[type].width, canvas[type].height);
 }
 
 void graphics_clear_city_viewport(void) {
     int x, y, width, height;
     city_view_get_unscaled_viewport(&x, &y, &width, &height);
+    graphics_mark_dirty(0, y + TOP_MENU_HEIGHT[GAME_ENV], width, height - y);
     while (y < height) {
         memset(graphics_get_pixel(0, y + TOP_MENU_HEIGHT[GAME_ENV]), 0, width * sizeof(color_t));
         y++;
@@ -271,11 +419,12 @@ void graphics_draw_vertical_line(int x, int y1, int y2, color_t color) {
     int y_max = y1 < y2 ? y2 : y1;
     y_min = y_min < clip_rectangle.y_start ? clip_rectangle.y_start : y_min;
     y_max = y_max >= clip_rectangle.y_end ? clip_rectangle.y_end - 1 : y_max;
+    mark_active_dirty(x, y_min, x + 1, y_max + 1);
     color_t *pixel = graphics_get_pixel(x, y_min);
-    color_t *end_pixel = pixel + ((y_max - y_min) * canvas[active_canvas].width);
+    color_t *end_pixel = pixel + ((y_max - y_min) * get_active_canvas()->width);
     while (pixel <= end_pixel) {
         *pixel = color;
-        pixel += canvas[active_canvas].width;
+        pixel += get_active_canvas()->width;
     }
 }
 
@@ -286,6 +435,7 @@ void graphics_draw_horizontal_line(int x1, int x2, int y, color_t color) {
     int x_max = x1 < x2 ? x2 : x1;
     x_min = x_min < clip_rectangle.x_start ? clip_rectangle.x_start : x_min;
     x_max = x_max >= clip_rectangle.x_end ? clip_rectangle.x_end - 1 : x_max;
+    mark_active_dirty(x_min, y, x_max + 1, y + 1);
     color_t *pixel = graphics_get_pixel(x_min, y);
     color_t *end_pixel = pixel + (x_max - x_min);
     while (pixel <= end_pixel) {
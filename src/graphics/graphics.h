@@ -32,6 +32,13 @@ typedef struct {
     int is_visible;
 } clip_info;
 
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} graphics_rect;
+
 void graphics_init_canvas(int width, int height);
 const void *graphics_canvas(canvas_type type);
 void graphics_set_active_canvas(canvas_type type);
@@ -42,9 +49,30 @@ void graphics_in_dialog(void);
 void graphics_reset_dialog(void);
 
 void graphics_set_clip_rectangle(int x, int y, int width, int height);
+void graphics_get_clip_rectangle(int *x, int *y, int *width, int *height);
 void graphics_reset_clip_rectangle(void);
+/**
+ * Gets how an area is clipped, and marks its visible part as changed: every drawing function calls this
+ */
 const clip_info *graphics_get_clip_info(int x, int y, int width, int height, bool mirrored = false);
 
+/**
+ * Marks an area of the active canvas as changed, for code that writes pixels without getting clip info
+ */
+void graphics_mark_dirty(int x, int y, int width, int height);
+/**
+ * Marks the whole UI and city canvas as changed, e.g. when the window contents were lost
+ */
+void graphics_mark_all_dirty(void);
+/**
+ * Gets the areas of a canvas that changed since the last call, and resets them
+ * @param type Canvas
+ * @param rects Filled with the changed areas
+ * @param max_rects Size of rects; the whole canvas is returned if more areas changed
+ * @return Number of changed areas, 0 if nothing changed
+ */
+int graphics_take_dirty_rects(canvas_type type, graphics_rect *rects, int max_rects);
+
 void graphics_save_to_buffer(int x, int y, int width, int height, color_t *buffer);
 void graphics_draw_from_buffer(int x, int y, int width, int height, const color_t *buffer);
 
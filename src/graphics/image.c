@@ -1,6 +1,7 @@
 #include "image.h"
 
 #include "core/log.h"
+#include "graphics/blit.h"
 #include "graphics/graphics.h"
 #include "graphics/screen.h"
 
@@ -285,11 +286,19 @@ static void draw_uncompressed(const image *img, const color_t *data, int x_offse
         data += clip->clipped_pixels_right;
     }
 }
+// number of pixels of the run starting at x that are inside the clip rectangle; skip is set to the clipped start
+static int visible_span(const image *img, const clip_info *clip, int x, int num_pixels, int *skip) {
+    int x_max = img->width - clip->clipped_pixels_right;
+    int end = x + num_pixels < x_max ? x + num_pixels : x_max;
+    *skip = x < clip->clipped_pixels_left ? clip->clipped_pixels_left - x : 0;
+    return end - x - *skip;
+}
 static void draw_compressed(const image *img, const color_t *data, int x_offset, int y_offset, int height) {
     bool mirr = (img->offset_mirror != 0);
     const clip_info *clip = graphics_get_clip_info(x_offset, y_offset, img->width, height, mirr);
     if (!clip->is_visible)
         return;
+    const blit_functions *blit = blit_get();
     int unclipped = clip->clip_x == CLIP_NONE;
 
     for (int y = 0; y < height - clip->clipped_pixels_bottom; y++) {
@@ -316,16 +325,10 @@ static void draw_compressed(const image *img, const color_t *data, int x_offset,
                 if (unclipped) {
                     x += b;
                     if (mirr)
-                        for (int px = 0; px < b; px++) {
-                            int pcorr = b - px - 1;
-                            memcpy(dst + px, pixels + pcorr, sizeof(color_t));
-                        }
+                        blit->copy_mirrored(dst, pixels, b);
                     else
-                        memcpy(dst, pixels, b * sizeof(color_t));
-                } else {
-                    if (mirr)
-                        int a = 3565;
-
+                        blit->copy(dst, pixels, b);
+                } else if (mirr) {
                     while (b) {
                         if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right)
                             *dst = *pixels;
@@ -335,6 +338,12 @@ static void draw_compressed(const image *img, const color_t *data, int x_offset,
                         pixels++;
                         b--;
                     }
+                } else {
+                    int skip;
+                    int visible = visible_span(img, clip, x, b, &skip);
+                    if (visible > 0)
+                        blit->copy(dst + skip, pixels + skip, visible);
+                    x += b;
                 }
             }
         }
@@ -344,6 +353,7 @@ static void draw_compressed_set(const image *img, const color_t *data, int x_off
     const clip_info *clip = graphics_get_clip_info(x_offset, y_offset, img->width, height);
     if (!clip->is_visible)
         return;
+    const blit_functions *blit = blit_get();
     int unclipped = clip->clip_x == CLIP_NONE;
 
     for (int y = 0; y < height - clip->clipped_pixels_bottom; y++) {
@@ -361,23 +371,15 @@ static void draw_compressed_set(const image *img, const color_t *data, int x_off
             } else {
                 data += b;
                 color_t *dst = graphics_get_pixel(x_offset + x, y_offset + y);
-                if (unclipped) {
-                    x += b;
-                    while (b) {
-                        *dst = color;
-                        dst++;
-                        b--;
-                    }
-                } else {
-                    while (b) {
-                        if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right)
-                            *dst = color;
-
-                        dst++;
-                        x++;
-                        b--;
-                    }
+                if (unclipped)
+                    blit->fill(dst, color, b);
+                else {
+                    int skip;
+                    int visible = visible_span(img, clip, x, b, &skip);
+                    if (visible > 0)
+                        blit->fill(dst + skip, color, visible);
                 }
+                x += b;
             }
         }
     }
@@ -386,6 +388,7 @@ static void draw_compressed_and(const image *img, const color_t *data, int x_off
     const clip_info *clip = graphics_get_clip_info(x_offset, y_offset, img->width, height);
     if (!clip->is_visible)
         return;
+    const blit_functions *blit = blit_get();
     int unclipped = clip->clip_x == CLIP_NONE;
 
     for (int y = 0; y < height - clip->clipped_pixels_bottom; y++) {
@@ -405,25 +408,15 @@ static void draw_compressed_and(const image *img, const color_t *data, int x_off
                 const color_t *pixels = data;
                 data += b;
                 color_t *dst = graphics_get_pixel(x_offset + x, y_offset + y);
-                if (unclipped) {
-                    x += b;
-                    while (b) {
-                        *dst = *pixels & color;
-                        dst++;
-                        pixels++;
-                        b--;
-                    }
-                } else {
-                    while (b) {
-                        if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right)
-                            *dst = *pixels & color;
-
-                        dst++;
-                        x++;
-                        pixels++;
-                        b--;
-                    }
+                if (unclipped)
+                    blit->and_src(dst, pixels, color, b);
+                else {
+                    int skip;
+                    int visible = visible_span(img, clip, x, b, &skip);
+                    if (visible > 0)
+                        blit->and_src(dst + skip, pixels + skip, color, visible);
                 }
+                x += b;
             }
         }
     }
@@ -432,6 +425,7 @@ static void draw_compressed_blend(const image *img, const color_t *data, int x_o
     const clip_info *clip = graphics_get_clip_info(x_offset, y_offset, img->width, height);
     if (!clip->is_visible)
         return;
+    const blit_functions *blit = blit_get();
     int unclipped = clip->clip_x == CLIP_NONE;
 
     for (int y = 0; y < height - clip->clipped_pixels_bottom; y++) {
@@ -449,23 +443,15 @@ static void draw_compressed_blend(const image *img, const color_t *data, int x_o
             } else {
                 data += b;
                 color_t *dst = graphics_get_pixel(x_offset + x, y_offset + y);
-                if (unclipped) {
-                    x += b;
-                    while (b) {
-                        *dst &= color;
-                        dst++;
-                        b--;
-                    }
-                } else {
-                    while (b) {
-                        if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right)
-                            *dst &= color;
-
-                        dst++;
-                        x++;
-                        b--;
-                    }
+                if (unclipped)
+                    blit->and_dst(dst, color, b);
+                else {
+                    int skip;
+                    int visible = visible_span(img, clip, x, b, &skip);
+                    if (visible > 0)
+                        blit->and_dst(dst + skip, color, visible);
                 }
+                x += b;
             }
         }
     }
@@ -482,9 +468,7 @@ static void draw_compressed_blend_alpha(const image *img, const color_t *data, i
         draw_compressed_set(img, data, x_offset, y_offset, height, color);
         return;
     }
-    color_t alpha_dst = 256 - alpha;
-    color_t src_rb = (color & 0xff00ff) * alpha;
-    color_t src_g = (color & 0x00ff00) * alpha;
+    const blit_functions *blit = blit_get();
     int unclipped = clip->clip_x == CLIP_NONE;
 
     for (int y = 0; y < height - clip->clipped_pixels_bottom; y++) {
@@ -504,27 +488,16 @@ static void draw_compressed_blend_alpha(const image *img, const color_t *data, i
                 dst += b;
             } else {
                 data += b;
-                if (unclipped) {
-                    x += b;
-                    while (b) {
-                        color_t d = *dst;
-                        *dst = (((src_rb + (d & 0xff00ff) * alpha_dst) & 0xff00ff00) |
-                                ((src_g + (d & 0x00ff00) * alpha_dst) & 0x00ff0000)) >> 8;
-                        b--;
-                        dst++;
-                    }
-                } else {
-                    while (b) {
-                        if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right) {
-                            color_t d = *dst;
-                            *dst = (((src_rb + (d & 0xff00ff) * alpha_dst) & 0xff00ff00) |
-                                    ((src_g + (d & 0x00ff00) * alpha_dst) & 0x00ff0000)) >> 8;
-                        }
-                        dst++;
-                        x++;
-                        b--;
-                    }
+                if (unclipped)
+                    blit->blend_alpha(dst, color, b);
+                else {
+                    int skip;
+                    int visible = visible_span(img, clip, x, b, &skip);
+                    if (visible > 0)
+                        blit->blend_alpha(dst + skip, color, visible);
                 }
+                x += b;
+                dst += b;
             }
         }
     }
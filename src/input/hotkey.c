@@ -2,6 +2,7 @@
 
 #include "building/type.h"
 #include "city/constants.h"
+#include "core/profiler.h"
 #include "game/settings.h"
 #include "game/state.h"
 #include "game/system.h"
@@ -34,6 +35,8 @@ typedef struct {
     int resize_to;
     int save_screenshot;
     int save_city_screenshot;
+    int toggle_profiler;
+    int dump_profiler;
 } global_hotkeys;
 
 static struct {
@@ -216,6 +219,12 @@ static void add_definition(const hotkey_mapping *mapping) {
         case HOTKEY_SAVE_CITY_SCREENSHOT:
             def->action = &data.global_hotkey_state.save_city_screenshot;
             break;
+        case HOTKEY_TOGGLE_PROFILER:
+            def->action = &data.global_hotkey_state.toggle_profiler;
+            break;
+        case HOTKEY_DUMP_PROFILER:
+            def->action = &data.global_hotkey_state.dump_profiler;
+            break;
         case HOTKEY_BUILD_VACANT_HOUSE:
             def->action = &data.hotkey_state.building;
             def->value = BUILDING_HOUSE_VACANT_LOT;
@@ -455,4 +464,10 @@ void hotkey_handle_global_keys(void) {
 //    if (data.global_hotkey_state.save_city_screenshot) {
 //        graphics_save_screenshot(1);
 //    }
+    if (data.global_hotkey_state.toggle_profiler)
+        profiler_toggle();
+
+    if (data.global_hotkey_state.dump_profiler)
+        profiler_dump("profiler.csv");
+
 }
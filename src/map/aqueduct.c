@@ -36,21 +36,11 @@ void map_aqueduct_clear(void) {
     map_grid_clear(&aqueduct);
 }
 
-#include <stdlib.h>
-
 void map_aqueduct_backup(void) {
-
-    void *t = malloc(12);
-    uint16_t *x = (uint16_t *) t;
-
-    uint16_t g = x[2];
-    x[4] = 1;
-
-
-    map_grid_copy(&aqueduct, &aqueduct_backup);
+    map_grid_backup(&aqueduct, &aqueduct_backup);
 }
 void map_aqueduct_restore(void) {
-    map_grid_copy(&aqueduct_backup, &aqueduct);
+    map_grid_restore(&aqueduct, &aqueduct_backup);
 }
 
 void map_aqueduct_save_state(buffer *buf, buffer *backup) {
@@ -3,13 +3,59 @@
 #include "building/building.h"
 #include "building/model.h"
 #include "core/calc.h"
+#include "core/config.h"
+#include "core/game_environment.h"
+#include "core/log.h"
 #include "map/data.h"
 #include "map/grid.h"
 #include "map/property.h"
 #include "map/ring.h"
 #include "map/terrain.h"
 
-static grid_xx desirability_grid = {0, {FS_INT8, FS_INT8}};
+#include <string.h>
+
+#define MAX_BUILDING_SOURCES 5000
+
+enum {
+    SOURCE_NONE = 0,
+    SOURCE_PLAZA = 1,
+    SOURCE_EARTHQUAKE = 2,
+    SOURCE_GARDEN = 3,
+    SOURCE_RUBBLE = 4
+};
+
+extern int DEBUG_MODE;
+
+static grid<int8_t> desirability_grid;
+
+// Incremental mode: every source remembers what it stamped, so an update only takes back
+// the rings of changed sources and stamps their new ones. The sums are kept unclamped and
+// clamped per tile, which can differ from the full pass: that clamps after every ring.
+static grid<int16_t> desirability_sum;
+static grid<uint8_t> applied_terrain;
+static grid<int8_t> checked_grid;
+
+static struct {
+    int active;
+    int valid;
+    struct {
+        short type;
+        unsigned char x;
+        unsigned char y;
+        unsigned char size;
+    } applied_buildings[MAX_BUILDING_SOURCES];
+} incremental;
+
+static void change_desirability(int grid_offset, int desirability) {
+    if (incremental.active) {
+        int sum = map_grid_get(&desirability_sum, grid_offset) + desirability;
+        map_grid_set(&desirability_sum, grid_offset, sum);
+        map_grid_set(&desirability_grid, grid_offset, calc_bound(sum, -100, 100));
+    } else {
+        map_grid_set(&desirability_grid, grid_offset,
+                     calc_bound(map_grid_get(&desirability_grid, grid_offset) + desirability, -100, 100));
+    }
+}
 
 static void add_desirability_at_distance(int x, int y, int size, int distance, int desirability) {
     int partially_outside_map = 0;
@@ -26,19 +72,13 @@ static void add_desirability_at_distance(int x, int y, int size, int distance, i
     if (partially_outside_map) {
         for (int i = start; i < end; i++) {
             const ring_tile *tile = map_ring_tile(i);
-            if (map_ring_is_inside_map(x + tile->x, y + tile->y)) {
-                map_grid_set(&desirability_grid, base_offset + tile->grid_offset,
-                             calc_bound(
-                                     map_grid_get(&desirability_grid, base_offset + tile->grid_offset) + desirability,
-                                     -100, 100));
-            }
+            if (map_ring_is_inside_map(x + tile->x, y + tile->y))
+                change_desirability(base_offset + tile->grid_offset, desirability);
         }
     } else {
         for (int i = start; i < end; i++) {
             const ring_tile *tile = map_ring_tile(i);
-            map_grid_set(&desirability_grid, base_offset + tile->grid_offset,
-                         calc_bound(map_grid_get(&desirability_grid, base_offset + tile->grid_offset) + desirability,
-                                    -100, 100));
+            change_desirability(base_offset + tile->grid_offset, desirability);
         }
     }
 }
@@ -75,51 +115,149 @@ static void update_buildings(void) {
         }
     }
 }
+static int get_terrain_source(int grid_offset) {
+    int terrain = map_terrain_get(grid_offset);
+    if (map_property_is_plaza_or_earthquake(grid_offset)) {
+        if (terrain & TERRAIN_ROAD)
+            return SOURCE_PLAZA;
+        else if (terrain & TERRAIN_ROCK) {
+            // earthquake fault line: slight negative
+            return SOURCE_EARTHQUAKE;
+        } else {
+            // invalid plaza/earthquake flag
+            map_property_clear_plaza_or_earthquake(grid_offset);
+            return SOURCE_NONE;
+        }
+    } else if (terrain & TERRAIN_GARDEN)
+        return SOURCE_GARDEN;
+    else if (terrain & TERRAIN_RUBBLE)
+        return SOURCE_RUBBLE;
+    return SOURCE_NONE;
+}
+static void add_terrain_source(int x, int y, int source, int sign) {
+    int type;
+    switch (source) {
+        case SOURCE_PLAZA:
+            type = BUILDING_PLAZA;
+            break;
+        case SOURCE_EARTHQUAKE:
+            type = BUILDING_HOUSE_VACANT_LOT;
+            break;
+        case SOURCE_GARDEN:
+            type = BUILDING_GARDENS;
+            break;
+        case SOURCE_RUBBLE:
+            add_to_terrain(x, y, 1, -2 * sign, 1, sign, 2);
+            return;
+        default:
+            return;
+    }
+    const model_building *model = model_get_building(type);
+    add_to_terrain(x, y, 1,
+                   sign * model->desirability_value,
+                   model->desirability_step,
+                   sign * model->desirability_step_size,
+                   model->desirability_range);
+}
 static void update_terrain(void) {
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
-            int terrain = map_terrain_get(grid_offset);
-            if (map_property_is_plaza_or_earthquake(grid_offset)) {
-                int type;
-                if (terrain & TERRAIN_ROAD)
-                    type = BUILDING_PLAZA;
-                else if (terrain & TERRAIN_ROCK) {
-                    // earthquake fault line: slight negative
-                    type = BUILDING_HOUSE_VACANT_LOT;
-                } else {
-                    // invalid plaza/earthquake flag
-                    map_property_clear_plaza_or_earthquake(grid_offset);
-                    continue;
-                }
-                const model_building *model = model_get_building(type);
-                add_to_terrain(x, y, 1,
-                               model->desirability_value,
-                               model->desirability_step,
-                               model->desirability_step_size,
-                               model->desirability_range);
-            } else if (terrain & TERRAIN_GARDEN) {
-                const model_building *model = model_get_building(BUILDING_GARDENS);
-                add_to_terrain(x, y, 1,
-                               model->desirability_value,
-                               model->desirability_step,
-                               model->desirability_step_size,
-                               model->desirability_range);
-            } else if (terrain & TERRAIN_RUBBLE)
-                add_to_terrain(x, y, 1, -2, 1, 1, 2);
+            add_terrain_source(x, y, get_terrain_source(grid_offset), 1);
+        }
+    }
+}
 
+static void add_building_source(int type, int x, int y, int size, int sign) {
+    const model_building *model = model_get_building(type);
+    add_to_terrain(x, y, size,
+                   sign * model->desirability_value,
+                   model->desirability_step,
+                   sign * model->desirability_step_size,
+                   model->desirability_range);
+}
+static void update_changed_buildings(void) {
+    for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
+        building *b = building_get(i);
+        int type = b->state == BUILDING_STATE_VALID ? b->type : 0;
+        auto *applied = &incremental.applied_buildings[i];
+        if (applied->type == type && (!type || (applied->x == b->x && applied->y == b->y && applied->size == b->size)))
+            continue;
+        if (applied->type)
+            add_building_source(applied->type, applied->x, applied->y, applied->size, -1);
+        if (type)
+            add_building_source(type, b->x, b->y, b->size, 1);
+        applied->type = type;
+        applied->x = b->x;
+        applied->y = b->y;
+        applied->size = b->size;
+    }
+}
+static void update_changed_terrain(void) {
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            int source = get_terrain_source(grid_offset);
+            int applied = map_grid_get(&applied_terrain, grid_offset);
+            if (source == applied)
+                continue;
+            add_terrain_source(x, y, applied, -1);
+            add_terrain_source(x, y, source, 1);
+            map_grid_set(&applied_terrain, grid_offset, source);
         }
     }
 }
+static void restamp_all_sources(void) {
+    map_grid_clear(&desirability_grid);
+    map_grid_clear(&desirability_sum);
+    map_grid_clear(&applied_terrain);
+    memset(incremental.applied_buildings, 0, sizeof(incremental.applied_buildings));
+    update_changed_buildings();
+    update_changed_terrain();
+}
+static void check_incremental_grid(void) {
+    // restamping from nothing applied is the full recompute with the same per-tile clamping
+    map_grid_copy(&desirability_grid, &checked_grid);
+    restamp_all_sources();
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            if (map_grid_get(&checked_grid, grid_offset) != map_grid_get(&desirability_grid, grid_offset))
+                log_error("Desirability out of date at grid offset", 0, grid_offset);
+        }
+    }
+}
+static void update_incremental(void) {
+    incremental.active = 1;
+    if (!incremental.valid) {
+        restamp_all_sources();
+        incremental.valid = 1;
+    } else {
+        update_changed_buildings();
+        update_changed_terrain();
+        if (DEBUG_MODE == ENGINE_MODE_DEBUG)
+            check_incremental_grid();
+    }
+    incremental.active = 0;
+}
 
 void map_desirability_clear(void) {
     map_grid_clear(&desirability_grid);
+    incremental.valid = 0;
 }
 void map_desirability_update(void) {
+    if (config_get(CONFIG_GP_CH_INCREMENTAL_DESIRABILITY)) {
+        update_incremental();
+        return;
+    }
     map_desirability_clear();
     update_buildings();
     update_terrain();
 }
+void map_desirability_update_changed(void) {
+    if (config_get(CONFIG_GP_CH_INCREMENTAL_DESIRABILITY))
+        update_incremental();
+}
 int map_desirability_get(int grid_offset) {
     return map_grid_get(&desirability_grid, grid_offset);
 }
@@ -144,4 +282,5 @@ void map_desirability_save_state(buffer *buf) {
 }
 void map_desirability_load_state(buffer *buf) {
     map_grid_load_buffer(&desirability_grid, buf);
+    incremental.valid = 0;
 }
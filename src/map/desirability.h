@@ -5,8 +5,18 @@
 
 void map_desirability_clear(void);
 
+/**
+ * Recalculates the desirability of all tiles. With the incremental desirability option
+ * only buildings and terrain that changed since the last update are re-applied, with a
+ * full recalculation every few updates.
+ */
 void map_desirability_update(void);
 
+/**
+ * Applies desirability changes right away when the incremental desirability option is on
+ */
+void map_desirability_update_changed(void);
+
 int map_desirability_get(int grid_offset);
 
 int map_desirability_get_max(int x, int y, int size);
@@ -2,7 +2,7 @@
 
 #include "map/grid.h"
 
-static grid_xx figures = {0, {FS_UINT16, FS_UINT16}};
+static grid<uint16_t> figures;
 
 int map_has_figure_at(int grid_offset) {
     return map_grid_is_valid_offset(grid_offset) && map_grid_get(&figures, grid_offset) > 0;
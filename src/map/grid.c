@@ -181,6 +181,34 @@ const int ADJACENT_OFFSETS_PH[][21] = {
 #include "core/game_environment.h"
 #include <cassert>
 
+struct grid_journal {
+    int all_written;
+    int num_written;
+    int offsets[GRID_SIZE_PH * GRID_SIZE_PH];
+    uint8_t is_written[GRID_SIZE_PH * GRID_SIZE_PH];
+};
+
+static void journal_mark(grid_journal *journal, uint32_t at) {
+    if (journal->all_written || journal->is_written[at])
+        return;
+    journal->is_written[at] = 1;
+    journal->offsets[journal->num_written++] = at;
+}
+static void journal_mark_all(grid_journal *journal) {
+    if (journal)
+        journal->all_written = 1;
+}
+static void journal_clear(grid_journal *journal) {
+    if (journal->all_written) {
+        memset(journal->is_written, 0, sizeof(journal->is_written));
+    } else {
+        for (int i = 0; i < journal->num_written; i++)
+            journal->is_written[journal->offsets[i]] = 0;
+    }
+    journal->all_written = 0;
+    journal->num_written = 0;
+}
+
 void map_grid_init(grid_xx *grid) {
     grid->size_field = gr_sizes[grid->datatype[GAME_ENV]];
     grid->size_total = grid->size_field * grid_total_size[GAME_ENV];
@@ -223,6 +251,8 @@ void map_grid_set(grid_xx *grid, uint32_t at, int64_t value) {
         map_grid_init(grid);
     if (at >= grid_total_size[GAME_ENV])
         return;
+    if (grid->journal)
+        journal_mark(grid->journal, at);
 //    assert(at < grid_total_size[GAME_ENV]);
     switch (grid->datatype[GAME_ENV]) {
         case FS_UINT8:
@@ -248,6 +278,7 @@ void map_grid_set(grid_xx *grid, uint32_t at, int64_t value) {
 void map_grid_fill(grid_xx *grid, int64_t value) {
     if (!grid->initialized)
         map_grid_init(grid);
+    journal_mark_all(grid->journal);
     switch (grid->datatype[GAME_ENV]) {
         case FS_UINT8:
             memset(grid->items_xx, (uint8_t) value, grid->size_total);
@@ -272,6 +303,7 @@ void map_grid_fill(grid_xx *grid, int64_t value) {
 void map_grid_clear(grid_xx *grid) {
     if (!grid->initialized)
         map_grid_init(grid);
+    journal_mark_all(grid->journal);
     memset(grid->items_xx, 0, grid->size_total);
 }
 void map_grid_copy(grid_xx *src, grid_xx *dst) {
@@ -283,6 +315,7 @@ void map_grid_copy(grid_xx *src, grid_xx *dst) {
     assert(src->datatype[GAME_ENV] == dst->datatype[GAME_ENV]);
     assert(src->size_total == dst->size_total);
 
+    journal_mark_all(dst->journal);
     memcpy(dst->items_xx, src->items_xx, src->size_total);
 }
 
@@ -303,6 +336,7 @@ void map_grid_or(grid_xx *grid, uint32_t at, int mask) {
 void map_grid_and_all(grid_xx *grid, int mask) {
     if (!grid->initialized)
         map_grid_init(grid);
+    journal_mark_all(grid->journal);
     for (int i = 0; i < grid_total_size[GAME_ENV]; i++) {
         switch (grid->datatype[GAME_ENV]) {
             case FS_UINT8:
@@ -358,6 +392,7 @@ void map_grid_save_buffer(grid_xx *grid, buffer *buf) {
 void map_grid_load_buffer(grid_xx *grid, buffer *buf) {
     if (!grid->initialized)
         map_grid_init(grid);
+    journal_mark_all(grid->journal);
     switch (grid->datatype[GAME_ENV]) {
         case FS_UINT8:
             buf->read_raw(grid->items_xx, grid_total_size[GAME_ENV]);
@@ -393,6 +428,47 @@ void map_grid_load_buffer(grid_xx *grid, buffer *buf) {
     return;
 }
 
+static void copy_written(grid_xx *src, grid_xx *dst) {
+    if (!src->initialized)
+        map_grid_init(src);
+    if (!dst->initialized)
+        map_grid_init(dst);
+    if (!src->journal) {
+        // grid and backup share one journal, since writes to either make them differ
+        src->journal = (grid_journal *) calloc(1, sizeof(grid_journal));
+        src->journal->all_written = 1;
+        dst->journal = src->journal;
+    }
+    grid_journal *journal = src->journal;
+    assert(dst->journal == journal);
+    if (journal->all_written) {
+        memcpy(dst->items_xx, src->items_xx, src->size_total);
+    } else {
+        size_t size = src->size_field;
+        const uint8_t *from = (const uint8_t *) src->items_xx;
+        uint8_t *to = (uint8_t *) dst->items_xx;
+        for (int i = 0; i < journal->num_written; i++) {
+            size_t offset = journal->offsets[i] * size;
+            memcpy(&to[offset], &from[offset], size);
+        }
+    }
+    journal_clear(journal);
+}
+void map_grid_backup(grid_xx *grid, grid_xx *backup) {
+    copy_written(grid, backup);
+}
+void map_grid_restore(grid_xx *grid, grid_xx *backup) {
+    copy_written(backup, grid);
+}
+int map_grid_changes_since_backup(grid_xx *grid, const int **offsets) {
+    if (!grid->journal || grid->journal->all_written) {
+        *offsets = 0;
+        return -1;
+    }
+    *offsets = grid->journal->offsets;
+    return grid->journal->num_written;
+}
+
 void map_grid_data_init(int width, int height, int start_offset, int border_size) {
     if (0) {
         map_data.width = grid_size[GAME_ENV];
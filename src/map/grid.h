@@ -5,6 +5,8 @@
 #include "core/game_environment.h"
 
 #include <stdint.h>
+#include <string.h>
+#include <algorithm>
 
 enum {
     GRID_SIZE_C3 = 162,
@@ -45,6 +47,8 @@ static size_t gr_sizes[] = {
         sizeof(int32_t)
 };
 
+typedef struct grid_journal grid_journal;
+
 typedef struct {
     int initialized;
     char datatype[2];
@@ -52,6 +56,7 @@ typedef struct {
     int size_total;
 
     void *items_xx;
+    grid_journal *journal; // tiles that may differ from the backup, see map_grid_backup
 } grid_xx;
 
 void map_grid_init(grid_xx *grid);
@@ -68,6 +73,122 @@ void map_grid_and_all(grid_xx *grid, int mask);
 void map_grid_save_buffer(grid_xx *grid, buffer *buf);
 void map_grid_load_buffer(grid_xx *grid, buffer *buf);
 
+/**
+ * Copies the grid into its backup. From the first backup on, writes to either grid are journaled,
+ * so later backups and restores only copy the tiles written in between.
+ * A grid must always be paired with the same backup.
+ * @param grid Grid to back up
+ * @param backup Backup of the grid
+ */
+void map_grid_backup(grid_xx *grid, grid_xx *backup);
+/**
+ * Copies the backup into the grid, only the tiles written since the last backup or restore
+ * @param grid Grid to restore
+ * @param backup Backup of the grid
+ */
+void map_grid_restore(grid_xx *grid, grid_xx *backup);
+/**
+ * Gets the tiles that may differ between a grid and its backup
+ * @param grid Grid that was backed up
+ * @param offsets Filled with the grid offsets
+ * @return Number of offsets, or -1 if the whole grid may differ
+ */
+int map_grid_changes_since_backup(grid_xx *grid, const int **offsets);
+
+/**
+ * Grid with the element type fixed at compile time.
+ *
+ * Storage is sized for the biggest map and allocated statically, so there is no lazy
+ * init and no datatype switch: the map_grid_* overloads below inline to a bounds check
+ * and a single indexed load/store. Use it for grids that have the same datatype in
+ * every GAME_ENV; save/load read and write grid_total_size[GAME_ENV] items of T,
+ * byte-for-byte the same as the equivalent grid_xx.
+ *
+ * Migrating a grid_xx is a one-line change of its declaration, e.g.
+ *   static grid_xx routing_distance = {0, {FS_INT16, FS_INT16}};
+ * becomes
+ *   static grid<int16_t> routing_distance;
+ * and all map_grid_*(&routing_distance, ...) call sites keep compiling unchanged.
+ */
+template <typename T>
+struct grid {
+    enum { CAPACITY = GRID_SIZE_PH * GRID_SIZE_PH };
+    T items[CAPACITY];
+};
+
+template <typename T>
+inline int64_t map_grid_get(const grid<T> *g, uint32_t at) {
+    if (at >= (uint32_t) grid_total_size[GAME_ENV])
+        return 0;
+    return g->items[at];
+}
+template <typename T>
+inline void map_grid_set(grid<T> *g, uint32_t at, int64_t value) {
+    if (at >= (uint32_t) grid_total_size[GAME_ENV])
+        return;
+    g->items[at] = (T) value;
+}
+template <typename T>
+inline void map_grid_fill(grid<T> *g, int64_t value) {
+    std::fill(g->items, g->items + grid<T>::CAPACITY, (T) value);
+}
+template <typename T>
+inline void map_grid_clear(grid<T> *g) {
+    memset(g->items, 0, sizeof(g->items));
+}
+template <typename T>
+inline void map_grid_copy(const grid<T> *src, grid<T> *dst) {
+    memcpy(dst->items, src->items, sizeof(src->items));
+}
+
+template <typename T>
+inline void map_grid_and(grid<T> *g, uint32_t at, int mask) {
+    if (at < (uint32_t) grid_total_size[GAME_ENV])
+        g->items[at] &= (T) mask;
+}
+template <typename T>
+inline void map_grid_or(grid<T> *g, uint32_t at, int mask) {
+    if (at < (uint32_t) grid_total_size[GAME_ENV])
+        g->items[at] |= (T) mask;
+}
+template <typename T>
+inline void map_grid_and_all(grid<T> *g, int mask) {
+    for (int i = 0; i < grid_total_size[GAME_ENV]; i++)
+        g->items[i] &= (T) mask;
+}
+
+inline void map_grid_write_item(buffer *buf, uint8_t value) { buf->write_u8(value); }
+inline void map_grid_write_item(buffer *buf, int8_t value) { buf->write_i8(value); }
+inline void map_grid_write_item(buffer *buf, uint16_t value) { buf->write_u16(value); }
+inline void map_grid_write_item(buffer *buf, int16_t value) { buf->write_i16(value); }
+inline void map_grid_write_item(buffer *buf, uint32_t value) { buf->write_u32(value); }
+inline void map_grid_write_item(buffer *buf, int32_t value) { buf->write_i32(value); }
+inline void map_grid_read_item(buffer *buf, uint8_t *value) { *value = buf->read_u8(); }
+inline void map_grid_read_item(buffer *buf, int8_t *value) { *value = buf->read_i8(); }
+inline void map_grid_read_item(buffer *buf, uint16_t *value) { *value = buf->read_u16(); }
+inline void map_grid_read_item(buffer *buf, int16_t *value) { *value = buf->read_i16(); }
+inline void map_grid_read_item(buffer *buf, uint32_t *value) { *value = buf->read_u32(); }
+inline void map_grid_read_item(buffer *buf, int32_t *value) { *value = buf->read_i32(); }
+
+template <typename T>
+inline void map_grid_save_buffer(const grid<T> *g, buffer *buf) {
+    if (sizeof(T) == 1) {
+        buf->write_raw(g->items, grid_total_size[GAME_ENV]);
+        return;
+    }
+    for (int i = 0; i < grid_total_size[GAME_ENV]; i++)
+        map_grid_write_item(buf, g->items[i]);
+}
+template <typename T>
+inline void map_grid_load_buffer(grid<T> *g, buffer *buf) {
+    if (sizeof(T) == 1) {
+        buf->read_raw(g->items, grid_total_size[GAME_ENV]);
+        return;
+    }
+    for (int i = 0; i < grid_total_size[GAME_ENV]; i++)
+        map_grid_read_item(buf, &g->items[i]);
+}
+
 void map_grid_data_init(int width, int height, int start_offset, int border_size);
 
 int map_grid_is_valid_offset(int grid_offset);
@@ -5,25 +5,69 @@
 static grid_xx images = {0, {FS_UINT16, FS_UINT32}};
 static grid_xx images_backup = {0, {FS_UINT16, FS_UINT32}};
 
+#define MAX_IMAGE_CHANGES 4096
+
+static struct {
+    int num;
+    int overflow;
+    int offsets[MAX_IMAGE_CHANGES];
+} image_changes;
+
+static void record_change(int grid_offset) {
+    if (image_changes.num < MAX_IMAGE_CHANGES)
+        image_changes.offsets[image_changes.num++] = grid_offset;
+    else
+        image_changes.overflow = 1;
+}
+static void record_all_changed(void) {
+    image_changes.overflow = 1;
+}
+
+int map_image_changes(const int **offsets) {
+    *offsets = image_changes.offsets;
+    return image_changes.overflow ? -1 : image_changes.num;
+}
+void map_image_changes_clear(void) {
+    image_changes.num = 0;
+    image_changes.overflow = 0;
+}
+
 int map_image_at(int grid_offset) {
     return map_grid_get(&images, grid_offset);
 }
 void map_image_set(int grid_offset, int image_id) {
+    if (map_grid_get(&images, grid_offset) == image_id)
+        return;
+    map_grid_set(&images, grid_offset, image_id);
+    record_change(grid_offset);
+}
+void map_image_set_animation_frame(int grid_offset, int image_id) {
     map_grid_set(&images, grid_offset, image_id);
 }
 
 void map_image_backup(void) {
-    map_grid_copy(&images, &images_backup);
+    map_grid_backup(&images, &images_backup);
 }
 void map_image_restore(void) {
-    map_grid_copy(&images_backup, &images);
+    const int *offsets;
+    int num_offsets = map_grid_changes_since_backup(&images, &offsets);
+    if (num_offsets < 0)
+        record_all_changed();
+    for (int i = 0; i < num_offsets; i++) {
+        record_change(offsets[i]);
+    }
+    map_grid_restore(&images, &images_backup);
+}
+int map_image_changes_since_backup(const int **offsets) {
+    return map_grid_changes_since_backup(&images, offsets);
 }
 void map_image_restore_at(int grid_offset) {
-    map_grid_set(&images, grid_offset, map_grid_get(&images_backup, grid_offset));
+    map_image_set(grid_offset, map_grid_get(&images_backup, grid_offset));
 }
 
 void map_image_clear(void) {
     map_grid_clear(&images);
+    record_all_changed();
 }
 void map_image_init_edges(void) {
     int width, height;
@@ -37,6 +81,7 @@ void map_image_init_edges(void) {
     map_grid_set(&images, map_grid_offset(0, height), 3);
     map_grid_set(&images, map_grid_offset(width, 0), 4);
     map_grid_set(&images, map_grid_offset(width, height), 5);
+    record_all_changed();
 }
 
 void map_image_save_state(buffer *buf) {
@@ -48,4 +93,5 @@ void map_image_load_state(buffer *buf, int shift) {
         auto nv = map_grid_get(&images, i) - shift;
         map_grid_set(&images, i, nv);
     }
+    record_all_changed();
 }
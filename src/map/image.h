@@ -6,11 +6,30 @@
 int map_image_at(int grid_offset);
 
 void map_image_set(int grid_offset, int image_id);
+/**
+ * Sets the image of an animated tile without recording a change: animated tiles are redrawn every frame
+ */
+void map_image_set_animation_frame(int grid_offset, int image_id);
+
+/**
+ * Gets the tiles whose image changed since the last clear
+ * @param offsets Out: grid offsets of the changed tiles
+ * @return Number of changed tiles, or -1 if too many changed to list them
+ */
+int map_image_changes(const int **offsets);
+void map_image_changes_clear(void);
 
 void map_image_backup(void);
 
 void map_image_restore(void);
 
+/**
+ * Gets the tiles whose image may differ from the backup
+ * @param offsets Out: grid offsets of the tiles
+ * @return Number of tiles, or -1 if the whole map may differ
+ */
+int map_image_changes_since_backup(const int **offsets);
+
 void map_image_restore_at(int grid_offset);
 
 void map_image_clear(void);
@@ -168,12 +168,12 @@ void map_property_clear(void) {
 }
 
 void map_property_backup(void) {
-    map_grid_copy(&bitfields_grid, &bitfields_backup);
-    map_grid_copy(&edge_grid, &edge_backup);
+    map_grid_backup(&bitfields_grid, &bitfields_backup);
+    map_grid_backup(&edge_grid, &edge_backup);
 }
 void map_property_restore(void) {
-    map_grid_copy(&bitfields_backup, &bitfields_grid);
-    map_grid_copy(&edge_backup, &edge_grid);
+    map_grid_restore(&bitfields_grid, &bitfields_backup);
+    map_grid_restore(&edge_grid, &edge_backup);
 }
 void map_property_save_state(buffer *bitfields, buffer *edge) {
     map_grid_save_buffer(&bitfields_grid, bitfields);
@@ -3,17 +3,19 @@
 #include "city/map.h"
 #include "map/data.h"
 #include "map/grid.h"
+#include "map/routing_data.h"
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 
 #include <string.h>
 
 #define MAX_QUEUE 1000
+#define MAX_COMPONENT_ID 65535
 
 static const int ADJACENT_OFFSETS_C3[] = {-GRID_SIZE_C3, 1, GRID_SIZE_C3, -1};
 static const int ADJACENT_OFFSETS_PH[] = {-GRID_SIZE_PH, 1, GRID_SIZE_PH, -1};
 
-static grid_xx network = {0, {FS_UINT8, FS_UINT8}};
+static grid<uint8_t> network;
 
 static struct {
     int items[MAX_QUEUE];
@@ -21,6 +23,19 @@ static struct {
     int tail;
 } queue;
 
+// Connected components of the tiles passable for each way of citizen travel. Component ids
+// are union-find labels: joining two components only links their roots, splitting one
+// relabels the pieces with fresh ids. Tiles that aren't passable have id 0.
+static struct {
+    grid<uint16_t> component;
+    uint16_t parent[MAX_COMPONENT_ID + 1];
+    int next_id;
+} connectivity[NUM_CONNECTIVITY_TYPES];
+static int connectivity_initialized;
+
+static int changed_offsets[GRID_SIZE_PH * GRID_SIZE_PH];
+static int flood_stack[GRID_SIZE_PH * GRID_SIZE_PH];
+
 int adjacent_offsets(int i) {
     switch (GAME_ENV) {
         case ENGINE_ENV_C3:
@@ -94,3 +109,148 @@ void map_road_network_update(void) {
         }
     }
 }
+
+static int is_passable_for(int type, int terrain) {
+    switch (type) {
+        case CONNECTIVITY_ROAD:
+            return terrain >= CITIZEN_0_ROAD && terrain < CITIZEN_2_PASSABLE_TERRAIN;
+        case CONNECTIVITY_ROAD_GARDEN:
+            return terrain >= CITIZEN_0_ROAD && terrain <= CITIZEN_2_PASSABLE_TERRAIN;
+        default:
+            return terrain >= 0;
+    }
+}
+static int is_passable(int type, int grid_offset) {
+    return is_passable_for(type, map_grid_get(&terrain_land_citizen, grid_offset));
+}
+static int is_inside_grid(int grid_offset) {
+    return grid_offset >= 0 && grid_offset < grid_total_size[GAME_ENV];
+}
+static int find_root(int type, int id) {
+    uint16_t *parent = connectivity[type].parent;
+    while (parent[id] != id) {
+        parent[id] = parent[parent[id]];
+        id = parent[id];
+    }
+    return id;
+}
+static int new_component(int type) {
+    if (connectivity[type].next_id > MAX_COMPONENT_ID)
+        return 0;
+    int id = connectivity[type].next_id++;
+    connectivity[type].parent[id] = id;
+    return id;
+}
+// labels the tiles connected to grid_offset that weren't labeled since min_id was handed out
+static void flood_component(int type, int grid_offset, int id, int min_id) {
+    grid<uint16_t> *component = &connectivity[type].component;
+    int size = 0;
+    map_grid_set(component, grid_offset, id);
+    flood_stack[size++] = grid_offset;
+    while (size) {
+        int offset = flood_stack[--size];
+        for (int i = 0; i < 4; i++) {
+            int next_offset = offset + adjacent_offsets(i);
+            if (is_inside_grid(next_offset) && map_grid_get(component, next_offset) < min_id &&
+                is_passable(type, next_offset)) {
+                map_grid_set(component, next_offset, id);
+                flood_stack[size++] = next_offset;
+            }
+        }
+    }
+}
+static void rebuild_connectivity(int type) {
+    map_grid_clear(&connectivity[type].component);
+    connectivity[type].next_id = 1;
+    for (int grid_offset = 0; grid_offset < grid_total_size[GAME_ENV]; grid_offset++) {
+        if (is_passable(type, grid_offset) && !map_grid_get(&connectivity[type].component, grid_offset))
+            flood_component(type, grid_offset, new_component(type), 1);
+    }
+}
+// returns 0 when the ids ran out and the components have to be rebuilt
+static int update_connectivity(int type, const grid<int8_t> *previous) {
+    grid<uint16_t> *component = &connectivity[type].component;
+    int num_removed = 0;
+    int num_added = 0;
+    for (int grid_offset = 0; grid_offset < grid_total_size[GAME_ENV]; grid_offset++) {
+        int before = previous->items[grid_offset];
+        int now = terrain_land_citizen.items[grid_offset];
+        if (before == now)
+            continue;
+        int was_passable = is_passable_for(type, before);
+        if (was_passable == is_passable_for(type, now))
+            continue;
+        if (was_passable) {
+            map_grid_set(component, grid_offset, 0);
+            changed_offsets[num_removed++] = grid_offset;
+        } else {
+            num_added++;
+        }
+    }
+    if (num_removed + num_added > grid_total_size[GAME_ENV] / 8)
+        return 0;
+
+    // a removed tile may split its component: relabel everything still reachable next to it
+    int min_id = connectivity[type].next_id;
+    for (int i = 0; i < num_removed; i++) {
+        for (int d = 0; d < 4; d++) {
+            int offset = changed_offsets[i] + adjacent_offsets(d);
+            if (is_inside_grid(offset) && map_grid_get(component, offset) < min_id && is_passable(type, offset)) {
+                int id = new_component(type);
+                if (!id)
+                    return 0;
+                flood_component(type, offset, id, min_id);
+            }
+        }
+    }
+    // an added tile joins the components around it
+    for (int grid_offset = 0; grid_offset < grid_total_size[GAME_ENV] && num_added; grid_offset++) {
+        int before = previous->items[grid_offset];
+        int now = terrain_land_citizen.items[grid_offset];
+        if (before == now || is_passable_for(type, before) || !is_passable_for(type, now))
+            continue;
+        num_added--;
+        if (map_grid_get(component, grid_offset))
+            continue; // already reached by a relabel above
+        int id = new_component(type);
+        if (!id)
+            return 0;
+        map_grid_set(component, grid_offset, id);
+        for (int d = 0; d < 4; d++) {
+            int offset = grid_offset + adjacent_offsets(d);
+            int neighbour_id = is_inside_grid(offset) ? map_grid_get(component, offset) : 0;
+            if (neighbour_id) {
+                int root = find_root(type, neighbour_id);
+                int own_root = find_root(type, id);
+                if (root != own_root)
+                    connectivity[type].parent[root] = own_root;
+            }
+        }
+    }
+    return 1;
+}
+void map_road_network_update_connectivity(const grid<int8_t> *previous) {
+    for (int type = 0; type < NUM_CONNECTIVITY_TYPES; type++) {
+        if (!connectivity_initialized || !update_connectivity(type, previous))
+            rebuild_connectivity(type);
+    }
+    connectivity_initialized = 1;
+}
+int map_road_network_connected(int type, int src_offset, int dst_offset) {
+    if (src_offset == dst_offset)
+        return 1;
+    if (!is_inside_grid(src_offset) || !is_inside_grid(dst_offset) || !is_passable(type, dst_offset))
+        return 0;
+    int dst_root = find_root(type, map_grid_get(&connectivity[type].component, dst_offset));
+    // the search starts from the source tile even when the source itself isn't passable
+    if (is_passable(type, src_offset))
+        return find_root(type, map_grid_get(&connectivity[type].component, src_offset)) == dst_root;
+    for (int d = 0; d < 4; d++) {
+        int offset = src_offset + adjacent_offsets(d);
+        if (is_inside_grid(offset) && is_passable(type, offset) &&
+            find_root(type, map_grid_get(&connectivity[type].component, offset)) == dst_root) {
+            return 1;
+        }
+    }
+    return 0;
+}
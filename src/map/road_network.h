@@ -1,10 +1,33 @@
 #ifndef MAP_ROAD_NETWORK_H
 #define MAP_ROAD_NETWORK_H
 
+#include "map/grid.h"
+
+enum {
+    CONNECTIVITY_ROAD,
+    CONNECTIVITY_ROAD_GARDEN,
+    CONNECTIVITY_LAND,
+    NUM_CONNECTIVITY_TYPES
+};
+
 void map_road_network_clear(void);
 
 int map_road_network_get(int grid_offset);
 
 void map_road_network_update(void);
 
+/**
+ * Updates the connected components of citizen-passable tiles after terrain_land_citizen changed
+ * @param previous The citizen terrain before the change
+ */
+void map_road_network_update_connectivity(const grid<int8_t> *previous);
+
+/**
+ * Checks whether a citizen route search from src_offset could ever reach dst_offset,
+ * ignoring figures on the way
+ * @param type One of CONNECTIVITY_ROAD, CONNECTIVITY_ROAD_GARDEN or CONNECTIVITY_LAND
+ * @return 1 if both tiles are in the same component
+ */
+int map_road_network_connected(int type, int src_offset, int dst_offset);
+
 #endif // MAP_ROAD_NETWORK_H
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <stdlib.h>
 #include "routing.h"
 
 #include "building/building.h"
@@ -6,11 +7,15 @@
 #include "map/figure.h"
 #include "map/grid.h"
 #include "map/road_aqueduct.h"
+#include "map/road_network.h"
 #include "map/routing_data.h"
 #include "map/terrain.h"
+#include "core/config.h"
 #include "core/game_environment.h"
+#include "core/profiler.h"
 
 #define MAX_QUEUE 162 * 162//grid_total_size[GAME_ENV]
+#define MAX_HEAP 2 * GRID_SIZE_PH * GRID_SIZE_PH
 #define GUARD 50000
 
 static const int ROUTE_OFFSETS[2][8] = {
@@ -18,12 +23,25 @@ static const int ROUTE_OFFSETS[2][8] = {
         {-228, 1, 228, -1, -227, 229, 227, -229}
 };
 
-static grid_xx routing_distance = {0, {FS_INT16, FS_INT16}};
+static grid<int16_t> routing_distance;
 
 static struct {
     int total_routes_calculated;
     int enemy_routes_calculated;
-} stats = {0, 0};
+    int queries;
+    int tiles_touched_last;
+    int64_t tiles_touched_total;
+} stats = {0, 0, 0, 0, 0};
+
+// offsets that were set to non-zero since the last clear, so clearing only has to reset those
+typedef struct {
+    int size;
+    int overflow;
+    int items[GRID_SIZE_PH * GRID_SIZE_PH];
+} touched_list;
+
+static touched_list touched_distances;
+static touched_list touched_water_drag;
 
 static struct {
     int head;
@@ -31,26 +49,163 @@ static struct {
     int items[MAX_QUEUE];
 } queue;
 
-static grid_xx water_drag = {0, {FS_UINT8, FS_UINT8}};
+static grid<uint8_t> water_drag;
 
 static struct {
     int through_building_id;
+    int point_to_point;
 } state;
 
+typedef struct {
+    int estimate;
+    int dist;
+    int offset;
+} heap_item;
+
+// open list for the point-to-point (A*) search: binary min-heap on estimated total distance
+static struct {
+    int active;
+    int overflow;
+    int dest_x;
+    int dest_y;
+    int size;
+    heap_item items[MAX_HEAP];
+} heap;
+
+static void mark_touched(touched_list *list, int offset) {
+    if (list->size >= GRID_SIZE_PH * GRID_SIZE_PH) {
+        list->overflow = 1;
+        return;
+    }
+    list->items[list->size++] = offset;
+}
+template <typename T>
+static void clear_touched(touched_list *list, grid<T> *g) {
+    if (list->overflow)
+        map_grid_clear(g);
+    else {
+        for (int i = 0; i < list->size; i++)
+            map_grid_set(g, list->items[i], 0);
+    }
+    list->size = 0;
+    list->overflow = 0;
+}
+
 static void clear_distances(void) {
-    map_grid_clear(&routing_distance);
+    clear_touched(&touched_distances, &routing_distance);
+}
+static void set_distance(int offset, int dist) {
+    if (!map_grid_get(&routing_distance, offset))
+        mark_touched(&touched_distances, offset);
+    map_grid_set(&routing_distance, offset, dist);
+}
+static void finish_query(void) {
+    stats.queries++;
+    stats.tiles_touched_last = touched_distances.size;
+    stats.tiles_touched_total += touched_distances.size;
 }
 static int valid_offset(int grid_offset) {
     return map_grid_is_valid_offset(grid_offset) && map_grid_get(&routing_distance, grid_offset) == 0;
 }
 
+static int heap_less(int a, int b) {
+    if (heap.items[a].estimate != heap.items[b].estimate)
+        return heap.items[a].estimate < heap.items[b].estimate;
+    // on equal estimates prefer the tile furthest along, so the search dives towards the destination
+    return heap.items[a].dist > heap.items[b].dist;
+}
+static void heap_swap(int a, int b) {
+    heap_item tmp = heap.items[a];
+    heap.items[a] = heap.items[b];
+    heap.items[b] = tmp;
+}
+static void heap_push(int offset, int dist) {
+    if (heap.size >= MAX_HEAP) {
+        heap.overflow = 1;
+        return;
+    }
+    int x = offset % grid_size[GAME_ENV];
+    int y = offset / grid_size[GAME_ENV];
+    int i = heap.size++;
+    heap.items[i].estimate = dist + abs(x - heap.dest_x) + abs(y - heap.dest_y);
+    heap.items[i].dist = dist;
+    heap.items[i].offset = offset;
+    while (i > 0 && heap_less(i, (i - 1) / 2)) {
+        heap_swap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+static void heap_pop(void) {
+    heap.items[0] = heap.items[--heap.size];
+    int i = 0;
+    while (1) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < heap.size && heap_less(left, smallest))
+            smallest = left;
+        if (right < heap.size && heap_less(right, smallest))
+            smallest = right;
+        if (smallest == i)
+            return;
+        heap_swap(i, smallest);
+        i = smallest;
+    }
+}
+
 static void enqueue(int offset, int dist) {
-    map_grid_set(&routing_distance, offset, dist);
+    set_distance(offset, dist);
+    if (heap.active) {
+        heap_push(offset, dist);
+        return;
+    }
     queue.items[queue.tail++] = offset;
     if (queue.tail >= MAX_QUEUE)
         queue.tail = 0;
 }
+// Heuristic search from source to dest, expanding at most max_tiles tiles. Tiles are
+// labeled the same way as with the full flood, so map_routing_get_path can walk back
+// from dest, but only the tiles around the best path get a distance.
+// Returns 0 if the open list overflowed and the caller needs to flood instead.
+static int route_queue_astar(int source, int dest, int max_tiles, void (*callback)(int next_offset, int dist)) {
+    clear_distances();
+    heap.active = 1;
+    heap.overflow = 0;
+    heap.size = 0;
+    heap.dest_x = dest % grid_size[GAME_ENV];
+    heap.dest_y = dest / grid_size[GAME_ENV];
+    enqueue(source, 1);
+    int tiles = 0;
+    while (heap.size > 0 && !heap.overflow) {
+        int offset = heap.items[0].offset;
+        int dist = heap.items[0].dist;
+        heap_pop();
+        if (dist != map_grid_get(&routing_distance, offset))
+            continue; // stale entry, a shorter way to this tile was found later
+        if (offset == dest)
+            break;
+        if (++tiles > max_tiles)
+            break;
+        dist++;
+        for (int i = 0; i < 4; i++) {
+            int next_offset = offset + ROUTE_OFFSETS[GAME_ENV][i];
+            if (!map_grid_is_valid_offset(next_offset))
+                continue;
+            int next_dist = map_grid_get(&routing_distance, next_offset);
+            // unlike the flood, a tile may be reached by a shorter way after it was first labeled
+            if (next_dist == 0 || next_dist > dist)
+                callback(next_offset, dist);
+        }
+    }
+    heap.active = 0;
+    if (heap.overflow)
+        return 0;
+    finish_query();
+    return 1;
+}
 static void route_queue(int source, int dest, void (*callback)(int next_offset, int dist)) {
+    if (state.point_to_point && route_queue_astar(source, dest, grid_total_size[GAME_ENV], callback))
+        return;
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
@@ -66,6 +221,7 @@ static void route_queue(int source, int dest, void (*callback)(int next_offset,
         if (++queue.head >= MAX_QUEUE)
             queue.head = 0;
     }
+    finish_query();
 }
 static void route_queue_until(int source, int (*callback)(int next_offset, int dist)) {
     clear_distances();
@@ -85,8 +241,11 @@ static void route_queue_until(int source, int (*callback)(int next_offset, int d
             queue.head = 0;
 
     }
+    finish_query();
 }
 static void route_queue_max(int source, int dest, int max_tiles, void (*callback)(int, int)) {
+    if (state.point_to_point && route_queue_astar(source, dest, max_tiles, callback))
+        return;
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
@@ -103,10 +262,11 @@ static void route_queue_max(int source, int dest, int max_tiles, void (*callback
         if (++queue.head >= MAX_QUEUE)
             queue.head = 0;
     }
+    finish_query();
 }
 static void route_queue_boat(int source, void (*callback)(int, int)) {
     clear_distances();
-    map_grid_clear(&water_drag);
+    clear_touched(&touched_water_drag, &water_drag);
     queue.head = queue.tail = 0;
     enqueue(source, 1);
     int tiles = 0;
@@ -128,10 +288,13 @@ static void route_queue_boat(int source, void (*callback)(int, int)) {
                     callback(offset + ROUTE_OFFSETS[GAME_ENV][i], dist);
             }
         }
+        if (!v)
+            mark_touched(&touched_water_drag, offset);
         map_grid_set(&water_drag, offset, v + 1);
         if (++queue.head >= MAX_QUEUE)
             queue.head = 0;
     }
+    finish_query();
 }
 static void route_queue_dir8(int source, void (*callback)(int, int)) {
     clear_distances();
@@ -150,6 +313,7 @@ static void route_queue_dir8(int source, void (*callback)(int, int)) {
         if (++queue.head >= MAX_QUEUE)
             queue.head = 0;
     }
+    finish_query();
 }
 
 static int queue_has(int offset) {
@@ -164,6 +328,7 @@ static void callback_calc_distance(int next_offset, int dist) {
         enqueue(next_offset, dist);
 }
 void map_routing_calculate_distances(int x, int y) {
+    PROFILE_SCOPE(PROFILER_ROUTE_DISTANCES);
     ++stats.total_routes_calculated;
     route_queue(map_grid_offset(x, y), -1, callback_calc_distance);
 }
@@ -174,7 +339,7 @@ static void callback_calc_distance_water_boat(int next_offset, int dist) {
         if (map_grid_get(&terrain_water, next_offset) == WATER_N2_MAP_EDGE) {
             int v = map_grid_get(&routing_distance, next_offset);
 //            safe_i16(&routing_distance)->items[next_offset] += 4;
-            map_grid_set(&routing_distance, next_offset, v + 4);
+            set_distance(next_offset, v + 4);
         }
     }
 }
@@ -205,7 +370,7 @@ static void callback_calc_distance_build_road(int next_offset, int dist) {
     switch (map_grid_get(&terrain_land_citizen, next_offset)) {
         case CITIZEN_N3_AQUEDUCT:
             if (!map_can_place_road_under_aqueduct(next_offset)) {
-                map_grid_set(&routing_distance, next_offset, -1);
+                set_distance(next_offset, -1);
                 blocked = 1;
             }
             break;
@@ -258,7 +423,7 @@ static void callback_calc_distance_build_aqueduct(int next_offset, int dist) {
             break;
     }
     if (map_terrain_is(next_offset, TERRAIN_ROAD) && !map_can_place_aqueduct_on_road(next_offset)) {
-        map_grid_set(&routing_distance, next_offset, -1);
+        set_distance(next_offset, -1);
         blocked = 1;
     }
     if (!blocked)
@@ -351,6 +516,13 @@ static int has_fighting_enemy(int grid_offset) {
     return map_figure_foreach_until(grid_offset, TEST_SEARCH_FIGHTING_ENEMY);
 }
 
+// no search can reach a tile in another component, so those routes are rejected up front
+static int is_connected(int connectivity_type, int src_offset, int dst_offset) {
+    if (map_road_network_connected(connectivity_type, src_offset, dst_offset))
+        return 1;
+    clear_distances();
+    return 0;
+}
 static void callback_travel_citizen_land(int next_offset, int dist) {
     if (map_grid_get(&terrain_land_citizen, next_offset) >= 0 && !has_fighting_friendly(next_offset))
         enqueue(next_offset, dist);
@@ -359,6 +531,8 @@ int map_routing_citizen_can_travel_over_land(int src_x, int src_y, int dst_x, in
     int src_offset = map_grid_offset(src_x, src_y);
     int dst_offset = map_grid_offset(dst_x, dst_y);
     ++stats.total_routes_calculated;
+    if (!is_connected(CONNECTIVITY_LAND, src_offset, dst_offset))
+        return 0;
     route_queue(src_offset, dst_offset, callback_travel_citizen_land);
     return map_grid_get(&routing_distance, dst_offset) != 0;
 }
@@ -372,6 +546,8 @@ int map_routing_citizen_can_travel_over_road(int src_x, int src_y, int dst_x, in
     int src_offset = map_grid_offset(src_x, src_y);
     int dst_offset = map_grid_offset(dst_x, dst_y);
     ++stats.total_routes_calculated;
+    if (!is_connected(CONNECTIVITY_ROAD, src_offset, dst_offset))
+        return 0;
     route_queue(src_offset, dst_offset, callback_travel_citizen_road);
     return map_grid_get(&routing_distance, dst_offset) != 0;
 }
@@ -385,6 +561,8 @@ int map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int ds
     int src_offset = map_grid_offset(src_x, src_y);
     int dst_offset = map_grid_offset(dst_x, dst_y);
     ++stats.total_routes_calculated;
+    if (!is_connected(CONNECTIVITY_ROAD_GARDEN, src_offset, dst_offset))
+        return 0;
     route_queue(src_offset, dst_offset, callback_travel_citizen_road_garden);
     return map_grid_get(&routing_distance, dst_offset) != 0;
 }
@@ -444,6 +622,10 @@ int map_routing_noncitizen_can_travel_through_everything(int src_x, int src_y, i
     return map_grid_get(&routing_distance, dst_offset) != 0;
 }
 
+void map_routing_set_point_to_point(int enabled) {
+    state.point_to_point = enabled && config_get(CONFIG_GP_CH_ASTAR_ROUTING);
+}
+
 void map_routing_block(int x, int y, int size) {
     if (!map_grid_is_inside(x, y, size))
         return;
@@ -456,6 +638,20 @@ void map_routing_block(int x, int y, int size) {
 int map_routing_distance(int grid_offset) {
     return map_grid_get(&routing_distance, grid_offset);
 }
+int map_routing_total_routes_calculated(void) {
+    return stats.total_routes_calculated;
+}
+void map_routing_count_cached_route(void) {
+    ++stats.total_routes_calculated;
+}
+int map_routing_tiles_touched_last(void) {
+    return stats.tiles_touched_last;
+}
+int map_routing_tiles_touched_average(void) {
+    if (!stats.queries)
+        return 0;
+    return (int) (stats.tiles_touched_total / stats.queries);
+}
 
 void map_routing_save_state(buffer *buf) {
     buf->write_i32(0); // unused counter
@@ -20,6 +20,21 @@ void map_routing_delete_first_wall_or_aqueduct(int x, int y);
 
 int map_routing_distance(int grid_offset);
 
+int map_routing_total_routes_calculated(void);
+/**
+ * Number of tiles that got a distance in the last routing query
+ */
+int map_routing_tiles_touched_last(void);
+/**
+ * Counts a route that was served from the path cache, so the saved statistics
+ * stay the same as when the route would have been searched
+ */
+void map_routing_count_cached_route(void);
+/**
+ * Average number of tiles that got a distance per routing query since startup
+ */
+int map_routing_tiles_touched_average(void);
+
 int map_routing_citizen_can_travel_over_land(int src_x, int src_y, int dst_x, int dst_y);
 int map_routing_citizen_can_travel_over_road(int src_x, int src_y, int dst_x, int dst_y);
 int map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int dst_x, int dst_y);
@@ -29,6 +44,14 @@ int map_routing_noncitizen_can_travel_over_land(int src_x, int src_y, int dst_x,
                                             int max_tiles);
 int map_routing_noncitizen_can_travel_through_everything(int src_x, int src_y, int dst_x, int dst_y);
 
+/**
+ * Lets the can_travel functions run a heuristic (A*) search that stops at the destination,
+ * if enabled in the config. Only tiles near the found path get a distance afterwards, which
+ * is enough for map_routing_get_path; leave it off when other distances are read later.
+ * @param enabled Whether point-to-point searches may be used
+ */
+void map_routing_set_point_to_point(int enabled);
+
 void map_routing_block(int x, int y, int size);
 
 void map_routing_save_state(buffer *buf);
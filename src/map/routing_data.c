@@ -1,6 +1,6 @@
 #include "routing_data.h"
 
-grid_xx terrain_land_citizen = {0, {FS_INT8, FS_INT8}};
-grid_xx terrain_land_noncitizen = {0, {FS_INT8, FS_INT8}};
-grid_xx terrain_water = {0, {FS_INT8, FS_INT8}};
-grid_xx terrain_walls = {0, {FS_INT8, FS_INT8}};
+grid<int8_t> terrain_land_citizen;
+grid<int8_t> terrain_land_noncitizen;
+grid<int8_t> terrain_water;
+grid<int8_t> terrain_walls;
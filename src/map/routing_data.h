@@ -28,9 +28,9 @@ enum {
     WALL_N1_BLOCKED = -1,
 };
 
-extern grid_xx terrain_land_citizen;
-extern grid_xx terrain_land_noncitizen;
-extern grid_xx terrain_water;
-extern grid_xx terrain_walls;
+extern grid<int8_t> terrain_land_citizen;
+extern grid<int8_t> terrain_land_noncitizen;
+extern grid<int8_t> terrain_water;
+extern grid<int8_t> terrain_walls;
 
 #endif // MAP_ROUTING_DATA_H
@@ -9,10 +9,48 @@
 #include "map/image.h"
 #include "map/property.h"
 #include "map/random.h"
+#include "map/road_network.h"
 #include "map/routing_data.h"
 #include "map/sprite.h"
 #include "map/terrain.h"
 
+#define MAX_PASSABILITY_CHANGES 64
+
+static grid<int8_t> previous_terrain;
+
+static struct {
+    int num;
+    int overflow;
+    int offsets[MAX_PASSABILITY_CHANGES];
+} passability_changes;
+
+static int is_citizen_road_passable(int value) {
+    return value >= CITIZEN_0_ROAD && value < CITIZEN_2_PASSABLE_TERRAIN;
+}
+static int is_wall_passable(int value) {
+    return value >= WALL_0_PASSABLE && value <= 2;
+}
+static void record_passability_changes(grid<int8_t> *terrain, int (*is_passable)(int value)) {
+    for (int i = 0; i < grid_total_size[GAME_ENV]; i++) {
+        if (previous_terrain.items[i] == terrain->items[i])
+            continue;
+        if (is_passable(previous_terrain.items[i]) == is_passable(terrain->items[i]))
+            continue;
+        if (passability_changes.num < MAX_PASSABILITY_CHANGES)
+            passability_changes.offsets[passability_changes.num++] = i;
+        else
+            passability_changes.overflow = 1;
+    }
+}
+int map_routing_passability_changes(const int **offsets) {
+    *offsets = passability_changes.offsets;
+    return passability_changes.overflow ? -1 : passability_changes.num;
+}
+void map_routing_passability_changes_clear(void) {
+    passability_changes.num = 0;
+    passability_changes.overflow = 0;
+}
+
 static int get_land_type_citizen_building(int grid_offset) {
     building *b = building_get(map_building_at(grid_offset));
     int type = CITIZEN_N1_BLOCKED;
@@ -194,6 +232,7 @@ static void map_routing_update_land_noncitizen(void) {
     }
 }
 void map_routing_update_land_citizen(void) {
+    map_grid_copy(&terrain_land_citizen, &previous_terrain);
     map_grid_fill(&terrain_land_citizen, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
@@ -225,6 +264,8 @@ void map_routing_update_land_citizen(void) {
             }
         }
     }
+    record_passability_changes(&terrain_land_citizen, is_citizen_road_passable);
+    map_road_network_update_connectivity(&previous_terrain);
 }
 void map_routing_update_water(void) {
     map_grid_fill(&terrain_water, -1);
@@ -256,6 +297,7 @@ void map_routing_update_water(void) {
     }
 }
 void map_routing_update_walls(void) {
+    map_grid_copy(&terrain_walls, &previous_terrain);
     map_grid_fill(&terrain_walls, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
@@ -273,6 +315,7 @@ void map_routing_update_walls(void) {
             }
         }
     }
+    record_passability_changes(&terrain_walls, is_wall_passable);
 }
 
 int map_routing_is_wall_passable(int grid_offset) {
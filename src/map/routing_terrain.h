@@ -7,6 +7,14 @@ void map_routing_update_land_citizen(void);
 void map_routing_update_water(void);
 void map_routing_update_walls(void);
 
+/**
+ * Gets the tiles where road or wall passability changed since the last clear
+ * @param offsets Out: grid offsets of the changed tiles
+ * @return Number of changed tiles, or -1 if too many changed to list them
+ */
+int map_routing_passability_changes(const int **offsets);
+void map_routing_passability_changes_clear(void);
+
 int map_routing_is_wall_passable(int grid_offset);
 int map_routing_wall_tile_in_radius(int x, int y, int radius, int *x_wall, int *y_wall);
 
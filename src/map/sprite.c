@@ -22,11 +22,11 @@ void map_sprite_clear(void) {
 }
 
 void map_sprite_backup(void) {
-    map_grid_copy(&sprite, &sprite_backup);
+    map_grid_backup(&sprite, &sprite_backup);
 }
 
 void map_sprite_restore(void) {
-    map_grid_copy(&sprite_backup, &sprite);
+    map_grid_restore(&sprite, &sprite_backup);
 }
 
 void map_sprite_save_state(buffer *buf, buffer *backup) {
@@ -497,10 +497,10 @@ void map_soil_depletion(int grid_offset, int malus) {
 /////
 
 void map_terrain_backup(void) {
-    map_grid_copy(&terrain_grid, &terrain_grid_backup);
+    map_grid_backup(&terrain_grid, &terrain_grid_backup);
 }
 void map_terrain_restore(void) {
-    map_grid_copy(&terrain_grid_backup, &terrain_grid);
+    map_grid_restore(&terrain_grid, &terrain_grid_backup);
 }
 void map_terrain_clear(void) {
     map_grid_clear(&terrain_grid);
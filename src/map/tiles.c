@@ -31,7 +31,7 @@
 
 static int aqueduct_include_construction = 0;
 
-//#include <chrono>
+#include "core/profiler.h"
 #include "SDL_log.h"
 
 static int is_clear(int x, int y, int size, int disallowed_terrain, int check_image) {
@@ -75,17 +75,9 @@ static void foreach_region_tile(int x_min, int y_min, int x_max, int y_max, void
     }
 }
 static void foreach_river_tile(void (*callback)(int x, int y, int grid_offset)) {
-//    auto start = std::chrono::steady_clock::now();
-//    std::chrono::nanoseconds clock_total;
-//    int clock_count = 0;
-
+    PROFILE_SCOPE(PROFILER_RIVER_TILES);
     for (int i = 0; i < river_total_tiles; i++)
         callback(all_river_tiles_x[i], all_river_tiles_y[i], all_river_tiles[i]);
-
-//    auto diff = std::chrono::steady_clock::now() - start;
-//    clock_total+= std::chrono::duration_cast<std::chrono::nanoseconds>(diff);
-//    clock_count++;
-//    SDL_Log("Average time: %i (%i cycles)", clock_total / clock_count, clock_count);
 }
 static void foreach_floodplain_order(int order, void (*callback)(int x, int y, int grid_offset, int order)) {
     if (order < 0 || order >= 30)
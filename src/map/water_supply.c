@@ -1,6 +1,7 @@
 #include "water_supply.h"
 
 #include "building/building.h"
+#include "building/count.h"
 #include "building/list.h"
 #include "core/image.h"
 #include "core/game_environment.h"
@@ -192,6 +193,7 @@ void map_water_supply_update_reservoir_fountain_C3(void) {
         building *b = building_get(reservoirs[i]);
         if (b->has_water_access)
             map_terrain_add_with_radius(b->x, b->y, 3, 10, TERRAIN_GROUNDWATER);
+        building_count_refresh(b);
     }
     // fountains
     for (int i = 1; i < MAX_BUILDINGS[GAME_ENV]; i++) {
@@ -217,6 +219,7 @@ void map_water_supply_update_reservoir_fountain_C3(void) {
                                         TERRAIN_FOUNTAIN_RANGE);
         } else
             b->has_water_access = 0;
+        building_count_refresh(b);
     }
 }
 void map_water_supply_update_wells_PH(void) {
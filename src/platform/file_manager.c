@@ -83,6 +83,11 @@ typedef const char * dir_name;
 
 #endif
 
+#if !defined(_WIN32) && !defined(__vita__) && !defined(__SWITCH__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 static int is_file(int mode) {
     return S_ISREG(mode) || S_ISLNK(mode);
 }
@@ -170,6 +175,35 @@ int platform_file_manager_remove_file(const char *filename) {
     return result == 0;
 }
 
+int platform_file_manager_rename_file(const char *from, const char *to) {
+    char *resolved_from = vita_prepend_path(from);
+    char *resolved_to = vita_prepend_path(to);
+    remove(resolved_to);
+    int result = rename(resolved_from, resolved_to);
+    free(resolved_from);
+    free(resolved_to);
+    return result == 0;
+}
+
+int platform_file_manager_get_file_info(const char *filename, int64_t *size, int64_t *modified_time) {
+    char *resolved_path = vita_prepend_path(filename);
+    struct stat file_info;
+    int result = stat(resolved_path, &file_info);
+    free(resolved_path);
+    if (result == -1)
+        return 0;
+    *size = file_info.st_size;
+    *modified_time = file_info.st_mtime;
+    return 1;
+}
+
+const void *platform_file_manager_map_file(const char *filename, size_t *size) {
+    return NULL;
+}
+
+void platform_file_manager_unmap_file(const void *data, size_t size) {
+}
+
 #elif defined(_WIN32)
 
 FILE *platform_file_manager_open_file(const char *filename, const char *mode) {
@@ -191,6 +225,55 @@ int platform_file_manager_remove_file(const char *filename) {
     return result == 0;
 }
 
+int platform_file_manager_rename_file(const char *from, const char *to) {
+    wchar_t *wfrom = utf8_to_wchar(from);
+    wchar_t *wto = utf8_to_wchar(to);
+    BOOL result = MoveFileExW(wfrom, wto, MOVEFILE_REPLACE_EXISTING);
+    free(wfrom);
+    free(wto);
+    return result != 0;
+}
+
+int platform_file_manager_get_file_info(const char *filename, int64_t *size, int64_t *modified_time) {
+    wchar_t *wfile = utf8_to_wchar(filename);
+    struct _stat64 file_info;
+    int result = _wstat64(wfile, &file_info);
+    free(wfile);
+    if (result == -1)
+        return 0;
+    *size = file_info.st_size;
+    *modified_time = file_info.st_mtime;
+    return 1;
+}
+
+const void *platform_file_manager_map_file(const char *filename, size_t *size) {
+    wchar_t *wfile = utf8_to_wchar(filename);
+    HANDLE file = CreateFileW(wfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    free(wfile);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || !file_size.QuadPart) {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping)
+        return NULL;
+    // the view keeps the mapping alive
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data)
+        return NULL;
+    *size = (size_t) file_size.QuadPart;
+    return data;
+}
+
+void platform_file_manager_unmap_file(const void *data, size_t size) {
+    UnmapViewOfFile(data);
+}
+
 #else
 
 FILE *platform_file_manager_open_file(const char *filename, const char *mode) {
@@ -201,4 +284,51 @@ int platform_file_manager_remove_file(const char *filename) {
     return remove(filename) == 0;
 }
 
+int platform_file_manager_rename_file(const char *from, const char *to) {
+    return rename(from, to) == 0;
+}
+
+int platform_file_manager_get_file_info(const char *filename, int64_t *size, int64_t *modified_time) {
+    struct stat file_info;
+    if (stat(filename, &file_info) == -1)
+        return 0;
+    *size = file_info.st_size;
+    *modified_time = file_info.st_mtime;
+    return 1;
+}
+
+#ifdef __SWITCH__
+
+const void *platform_file_manager_map_file(const char *filename, size_t *size) {
+    return NULL;
+}
+
+void platform_file_manager_unmap_file(const void *data, size_t size) {
+}
+
+#else
+
+const void *platform_file_manager_map_file(const char *filename, size_t *size) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+    struct stat file_info;
+    if (fstat(fd, &file_info) == -1 || !file_info.st_size) {
+        close(fd);
+        return NULL;
+    }
+    void *data = mmap(NULL, (size_t) file_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+    *size = (size_t) file_info.st_size;
+    return data;
+}
+
+void platform_file_manager_unmap_file(const void *data, size_t size) {
+    munmap((void *) data, size);
+}
+
+#endif
+
 #endif
@@ -1,6 +1,8 @@
 #ifndef PLATFORM_FILE_MANAGER_H
 #define PLATFORM_FILE_MANAGER_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 enum {
@@ -56,4 +58,36 @@ FILE *platform_file_manager_open_file(const char *filename, const char *mode);
  */
 int platform_file_manager_remove_file(const char *filename);
 
+/**
+ * Renames a file, replacing the destination if it exists
+ * @param from The file to rename
+ * @param to The new name of the file
+ * @return true if renaming was successful, false otherwise
+ */
+int platform_file_manager_rename_file(const char *from, const char *to);
+
+/**
+ * Gets the size and modification time of a file
+ * @param filename The file to query
+ * @param size Filled with the size of the file in bytes
+ * @param modified_time Filled with the modification time of the file
+ * @return true if the file exists, false otherwise
+ */
+int platform_file_manager_get_file_info(const char *filename, int64_t *size, int64_t *modified_time);
+
+/**
+ * Maps a file into memory for reading
+ * @param filename The file to map
+ * @param size Filled with the size of the mapping
+ * @return The contents of the file, or NULL if the file could not be mapped or the platform does not support it
+ */
+const void *platform_file_manager_map_file(const char *filename, size_t *size);
+
+/**
+ * Unmaps a file mapped with platform_file_manager_map_file
+ * @param data The contents of the file
+ * @param size The size of the mapping
+ */
+void platform_file_manager_unmap_file(const void *data, size_t size);
+
 #endif // PLATFORM_FILE_MANAGER_H
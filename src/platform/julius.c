@@ -8,6 +8,7 @@
 #include "core/game_environment.h"
 #include "game/game.h"
 #include "game/system.h"
+#include "graphics/graphics.h"
 #include "input/mouse.h"
 #include "input/touch.h"
 #include "platform/arguments.h"
@@ -44,7 +45,6 @@
 
 #ifdef DRAW_FPS
 #include "graphics/window.h"
-#include "graphics/graphics.h"
 #include "graphics/text.h"
 #endif
 
@@ -364,6 +364,11 @@ static void handle_window_event(SDL_WindowEvent *event, int *window_active) {
             platform_screen_move(event->data1, event->data2);
             break;
 
+        case SDL_WINDOWEVENT_EXPOSED:
+            // the renderer may have lost what was presented last
+            graphics_mark_all_dirty();
+            break;
+
         case SDL_WINDOWEVENT_SHOWN:
             SDL_Log("Window %d shown", (unsigned int) event->windowID);
             *window_active = 1;
@@ -382,6 +387,10 @@ static void handle_event(SDL_Event *event, int *active, int *quit) {
             handle_window_event(&event->window, active);
             break;
 #endif
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            graphics_mark_all_dirty();
+            break;
         case SDL_KEYDOWN:
             platform_handle_key_down(&event->key);
             break;
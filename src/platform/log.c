@@ -5,7 +5,7 @@
 
 #define MSG_SIZE 1000
 
-static char log_buffer[MSG_SIZE];
+static thread_local char log_buffer[MSG_SIZE];
 
 static const char *build_message(const char *msg, const char *param_str, int param_int) {
     int index = 0;
@@ -37,6 +37,9 @@ static struct {
 
 static int scale_percentage = 100;
 
+#define MAX_DIRTY_RECTS 64
+#define IDLE_FRAME_MILLIS 16
+
 static int scale_logical_to_pixels(int logical_value) {
     return logical_value * scale_percentage / 100;
 }
@@ -276,18 +279,37 @@ void platform_screen_center_window(void) {
     window_pos.centered = 1;
 }
 
+static void update_texture(SDL_Texture *texture, canvas_type type, int pitch_pixels, const graphics_rect *rects,
+                           int num_rects) {
+    const color_t *pixels = (const color_t *) graphics_canvas(type);
+    for (int i = 0; i < num_rects; i++) {
+        SDL_Rect rect = {rects[i].x, rects[i].y, rects[i].width, rects[i].height};
+        SDL_UpdateTexture(texture, &rect, &pixels[rect.y * pitch_pixels + rect.x], pitch_pixels * sizeof(color_t));
+    }
+}
+
 void platform_screen_render(void) {
+    graphics_rect ui_rects[MAX_DIRTY_RECTS];
+    graphics_rect city_rects[MAX_DIRTY_RECTS];
+    int num_ui_rects = graphics_take_dirty_rects(CANVAS_UI, ui_rects, MAX_DIRTY_RECTS);
+    int num_city_rects = 0;
+    if (config_get(CONFIG_UI_ZOOM))
+        num_city_rects = graphics_take_dirty_rects(CANVAS_CITY, city_rects, MAX_DIRTY_RECTS);
+    if (!num_ui_rects && !num_city_rects) {
+        // nothing to present, so vsync does not pace the main loop: wait for about one frame instead
+        SDL_Delay(IDLE_FRAME_MILLIS);
+        return;
+    }
     if (config_get(CONFIG_UI_ZOOM)) {
         SDL_RenderClear(SDL.renderer);
         city_view_get_unscaled_viewport(&city_texture_position.offset.x, &city_texture_position.offset.y,
                                         &city_texture_position.renderer.w, &city_texture_position.offset.h);
         city_view_get_scaled_viewport(&city_texture_position.offset.x, &city_texture_position.offset.y,
                                       &city_texture_position.offset.w, &city_texture_position.offset.h);
-        SDL_UpdateTexture(SDL.texture_city, &city_texture_position.offset, graphics_canvas(CANVAS_CITY),
-                          screen_width() * 4 * 2);
+        update_texture(SDL.texture_city, CANVAS_CITY, screen_width() * 2, city_rects, num_city_rects);
         SDL_RenderCopy(SDL.renderer, SDL.texture_city, &city_texture_position.offset, &city_texture_position.renderer);
     }
-    SDL_UpdateTexture(SDL.texture_ui, NULL, graphics_canvas(CANVAS_UI), screen_width() * 4);
+    update_texture(SDL.texture_ui, CANVAS_UI, screen_width(), ui_rects, num_ui_rects);
     SDL_RenderCopy(SDL.renderer, SDL.texture_ui, NULL, NULL);
     SDL_RenderPresent(SDL.renderer);
 }
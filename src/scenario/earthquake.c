@@ -1,6 +1,7 @@
 #include "earthquake.h"
 
 #include "building/building.h"
+#include "building/count.h"
 #include "building/destruction.h"
 #include "city/message.h"
 #include "core/calc.h"
@@ -73,7 +74,9 @@ static void advance_earthquake_to_tile(int x, int y) {
         sound_effect_play(SOUND_EFFECT_EXPLOSION);
         int ruin_id = map_building_at(grid_offset);
         if (ruin_id) {
-            building_get(ruin_id)->state = BUILDING_STATE_DELETED_BY_GAME;
+            building *ruin = building_get(ruin_id);
+            ruin->state = BUILDING_STATE_DELETED_BY_GAME;
+            building_count_refresh(ruin);
             map_building_set(grid_offset, 0);
         }
     }
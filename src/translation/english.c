@@ -72,6 +72,9 @@ static translation_string all_strings[] = {
         {TR_CONFIG_MULTIPLE_BARRACKS,                   "Allow building multiple barracks."},
         {TR_CONFIG_NOT_ACCEPTING_WAREHOUSES,            "Warehouses don't accept anything when built"},
         {TR_CONFIG_HOUSES_DONT_EXPAND_INTO_GARDENS,     "Houses don't expand into gardens"},
+        {TR_CONFIG_ASTAR_ROUTING,                       "Walkers use faster point-to-point routing"},
+        {TR_CONFIG_INCREMENTAL_DESIRABILITY,            "Desirability updates right after building"},
+        {TR_CONFIG_INCREMENTAL_BUILDING_COUNTS,         "Building counts update right after changes"},
         {TR_HOTKEY_TITLE,                               "Augustus hotkey configuration"},
         {TR_HOTKEY_LABEL,                               "Hotkey"},
         {TR_HOTKEY_ALTERNATIVE_LABEL,                   "Alternative"},
@@ -94,6 +97,8 @@ static translation_string all_strings[] = {
         {TR_HOTKEY_RESIZE_TO_1024,                      "Resize window to 1024x768"},
         {TR_HOTKEY_SAVE_SCREENSHOT,                     "Save screenshot"},
         {TR_HOTKEY_SAVE_CITY_SCREENSHOT,                "Save full city screenshot"},
+        {TR_HOTKEY_TOGGLE_PROFILER,                     "Toggle profiler"},
+        {TR_HOTKEY_DUMP_PROFILER,                       "Write profiler samples"},
         {TR_HOTKEY_LOAD_FILE,                           "Load file"},
         {TR_HOTKEY_SAVE_FILE,                           "Save file"},
         {TR_HOTKEY_INCREASE_GAME_SPEED,                 "Increase game speed"},
@@ -64,6 +64,9 @@ enum {
     TR_CONFIG_MULTIPLE_BARRACKS,
     TR_CONFIG_NOT_ACCEPTING_WAREHOUSES,
     TR_CONFIG_HOUSES_DONT_EXPAND_INTO_GARDENS,
+    TR_CONFIG_ASTAR_ROUTING,
+    TR_CONFIG_INCREMENTAL_DESIRABILITY,
+    TR_CONFIG_INCREMENTAL_BUILDING_COUNTS,
     TR_HOTKEY_TITLE,
     TR_HOTKEY_LABEL,
     TR_HOTKEY_ALTERNATIVE_LABEL,
@@ -86,6 +89,8 @@ enum {
     TR_HOTKEY_RESIZE_TO_1024,
     TR_HOTKEY_SAVE_SCREENSHOT,
     TR_HOTKEY_SAVE_CITY_SCREENSHOT,
+    TR_HOTKEY_TOGGLE_PROFILER,
+    TR_HOTKEY_DUMP_PROFILER,
     TR_HOTKEY_LOAD_FILE,
     TR_HOTKEY_SAVE_FILE,
     TR_HOTKEY_INCREASE_GAME_SPEED,
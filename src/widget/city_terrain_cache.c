@@ -0,0 +1,211 @@
+#include "city_terrain_cache.h"
+
+#include "core/thread_pool.h"
+#include "graphics/graphics.h"
+#include "map/image.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CHUNK_SIZE 256
+#define MAX_CHUNKS 256
+
+// how far a footprint reaches from the position of its draw tile, in map pixels
+#define FOOTPRINT_REACH_LEFT 30
+#define FOOTPRINT_REACH_RIGHT 300
+#define FOOTPRINT_REACH_UP 90
+#define FOOTPRINT_REACH_DOWN 120
+
+// how far a changed tile can be from the pixels that change: it may belong to a building of up to 5x5 tiles
+#define CHANGE_REACH_X 240
+#define CHANGE_REACH_Y 120
+
+typedef struct {
+    color_t *pixels;
+    int x;
+    int y;
+    int in_use;
+    int is_valid;
+    unsigned int last_used_frame;
+} chunk;
+
+static struct {
+    chunk chunks[MAX_CHUNKS];
+    chunk *visible[MAX_CHUNKS];
+    chunk *to_render[MAX_CHUNKS];
+    int num_to_render;
+    map_callback *draw_footprint;
+    int lookup_version;
+    unsigned int frame;
+} data;
+
+static thread_local struct {
+    int x;
+    int y;
+} render_origin;
+
+static int chunk_index(int pixel) {
+    return pixel >= 0 ? pixel / CHUNK_SIZE : -((CHUNK_SIZE - 1 - pixel) / CHUNK_SIZE);
+}
+
+void city_terrain_cache_invalidate(void) {
+    for (int i = 0; i < MAX_CHUNKS; i++) {
+        data.chunks[i].in_use = 0;
+    }
+}
+
+static void invalidate_area(int x_min, int y_min, int x_max, int y_max) {
+    int chunk_x_min = chunk_index(x_min);
+    int chunk_y_min = chunk_index(y_min);
+    int chunk_x_max = chunk_index(x_max);
+    int chunk_y_max = chunk_index(y_max);
+    for (int i = 0; i < MAX_CHUNKS; i++) {
+        chunk *c = &data.chunks[i];
+        if (c->in_use && c->x >= chunk_x_min && c->x <= chunk_x_max && c->y >= chunk_y_min && c->y <= chunk_y_max)
+            c->is_valid = 0;
+    }
+}
+
+static void apply_image_changes(void) {
+    const int *offsets;
+    int num_changes = map_image_changes(&offsets);
+    if (num_changes < 0 || data.lookup_version != city_view_lookup_version()) {
+        city_terrain_cache_invalidate();
+        data.lookup_version = city_view_lookup_version();
+    } else {
+        for (int i = 0; i < num_changes; i++) {
+            int x, y;
+            city_view_grid_offset_to_map_pixels(offsets[i], &x, &y);
+            invalidate_area(x - CHANGE_REACH_X, y - CHANGE_REACH_Y, x + CHANGE_REACH_X + 60, y + CHANGE_REACH_Y + 30);
+        }
+    }
+    map_image_changes_clear();
+}
+
+static chunk *find_chunk(int x, int y) {
+    for (int i = 0; i < MAX_CHUNKS; i++) {
+        chunk *c = &data.chunks[i];
+        if (c->in_use && c->x == x && c->y == y)
+            return c;
+    }
+    return 0;
+}
+
+static chunk *get_free_chunk(void) {
+    chunk *result = 0;
+    for (int i = 0; i < MAX_CHUNKS; i++) {
+        chunk *c = &data.chunks[i];
+        if (!c->in_use) {
+            result = c;
+            break;
+        }
+        // never evict a chunk that is visible this frame
+        if (c->last_used_frame != data.frame && (!result || c->last_used_frame < result->last_used_frame))
+            result = c;
+    }
+    if (!result)
+        return 0;
+    if (!result->pixels) {
+        result->pixels = (color_t *) malloc(sizeof(color_t) * CHUNK_SIZE * CHUNK_SIZE);
+        if (!result->pixels)
+            return 0;
+    }
+    return result;
+}
+
+static void draw_translated_footprint(int x, int y, int grid_offset) {
+    data.draw_footprint(x - render_origin.x, y - render_origin.y, grid_offset);
+}
+
+static void render_chunk(int index, void *userdata) {
+    chunk *c = data.to_render[index];
+    render_origin.x = c->x * CHUNK_SIZE;
+    render_origin.y = c->y * CHUNK_SIZE;
+    memset(c->pixels, 0, sizeof(color_t) * CHUNK_SIZE * CHUNK_SIZE);
+    graphics_set_custom_canvas(c->pixels, CHUNK_SIZE, CHUNK_SIZE);
+    city_view_foreach_tile_in_map_pixels(
+            render_origin.x - FOOTPRINT_REACH_RIGHT, render_origin.y - FOOTPRINT_REACH_DOWN,
+            render_origin.x + CHUNK_SIZE + FOOTPRINT_REACH_LEFT, render_origin.y + CHUNK_SIZE + FOOTPRINT_REACH_UP,
+            draw_translated_footprint);
+}
+
+static void render_chunks(void) {
+    int clip_x, clip_y, clip_width, clip_height;
+    graphics_get_clip_rectangle(&clip_x, &clip_y, &clip_width, &clip_height);
+    canvas_type canvas = graphics_get_canvas_type();
+
+    thread_pool_run(data.num_to_render, render_chunk, 0);
+
+    // this thread rendered chunks as well
+    graphics_set_active_canvas(canvas);
+    graphics_set_clip_rectangle(clip_x, clip_y, clip_width, clip_height);
+    for (int i = 0; i < data.num_to_render; i++) {
+        data.to_render[i]->is_valid = 1;
+    }
+}
+
+static void copy_chunk(const chunk *c, int x_min, int y_min, int x_max, int y_max, int origin_x, int origin_y) {
+    int chunk_x = c->x * CHUNK_SIZE;
+    int chunk_y = c->y * CHUNK_SIZE;
+    int x_start = x_min > chunk_x ? x_min : chunk_x;
+    int x_end = x_max < chunk_x + CHUNK_SIZE ? x_max : chunk_x + CHUNK_SIZE;
+    int y_start = y_min > chunk_y ? y_min : chunk_y;
+    int y_end = y_max < chunk_y + CHUNK_SIZE ? y_max : chunk_y + CHUNK_SIZE;
+    for (int y = y_start; y < y_end; y++) {
+        memcpy(graphics_get_pixel(x_start + origin_x, y + origin_y),
+               &c->pixels[(y - chunk_y) * CHUNK_SIZE + x_start - chunk_x], sizeof(color_t) * (x_end - x_start));
+    }
+}
+
+int city_terrain_cache_draw(map_callback *draw_footprint) {
+    apply_image_changes();
+    data.frame++;
+    data.draw_footprint = draw_footprint;
+
+    int clip_x, clip_y, clip_width, clip_height;
+    graphics_get_clip_rectangle(&clip_x, &clip_y, &clip_width, &clip_height);
+    if (clip_width <= 0 || clip_height <= 0)
+        return 1;
+    int origin_x, origin_y;
+    city_view_get_map_pixel_origin(&origin_x, &origin_y);
+    int x_min = clip_x - origin_x;
+    int y_min = clip_y - origin_y;
+    int x_max = x_min + clip_width;
+    int y_max = y_min + clip_height;
+
+    int chunk_x_min = chunk_index(x_min);
+    int chunk_y_min = chunk_index(y_min);
+    int chunk_x_max = chunk_index(x_max - 1);
+    int chunk_y_max = chunk_index(y_max - 1);
+    if ((chunk_x_max - chunk_x_min + 1) * (chunk_y_max - chunk_y_min + 1) > MAX_CHUNKS)
+        return 0;
+
+    int num_visible = 0;
+    data.num_to_render = 0;
+    for (int y = chunk_y_min; y <= chunk_y_max; y++) {
+        for (int x = chunk_x_min; x <= chunk_x_max; x++) {
+            chunk *c = find_chunk(x, y);
+            if (!c) {
+                c = get_free_chunk();
+                if (!c)
+                    return 0;
+                c->x = x;
+                c->y = y;
+                c->in_use = 1;
+                c->is_valid = 0;
+            }
+            c->last_used_frame = data.frame;
+            data.visible[num_visible++] = c;
+            if (!c->is_valid)
+                data.to_render[data.num_to_render++] = c;
+        }
+    }
+    if (data.num_to_render)
+        render_chunks();
+
+    for (int i = 0; i < num_visible; i++) {
+        copy_chunk(data.visible[i], x_min, y_min, x_max, y_max, origin_x, origin_y);
+    }
+    graphics_mark_dirty(clip_x, clip_y, clip_width, clip_height);
+    return 1;
+}
@@ -0,0 +1,26 @@
+#ifndef WIDGET_CITY_TERRAIN_CACHE_H
+#define WIDGET_CITY_TERRAIN_CACHE_H
+
+#include "city/view.h"
+
+/**
+ * @file
+ * Pre-rendered terrain footprints of the city, kept in chunks of map pixels.
+ * A chunk is rendered again when the image of a tile in it changes.
+ */
+
+/**
+ * Drops all rendered chunks
+ */
+void city_terrain_cache_invalidate(void);
+
+/**
+ * Copies the footprints of the visible part of the city into the clip rectangle of the active canvas,
+ * rendering missing and outdated chunks first.
+ * @param draw_footprint Draws the footprint of a tile; it may only depend on the tile's image and
+ *        building layout and has to be safe to run on several threads at once
+ * @return 1 if the footprints were drawn, 0 if the visible area is too big for the cache
+ */
+int city_terrain_cache_draw(map_callback *draw_footprint);
+
+#endif // WIDGET_CITY_TERRAIN_CACHE_H
@@ -18,6 +18,8 @@
 #include "city/ratings.h"
 #include "city/view.h"
 #include "core/config.h"
+#include "core/profiler.h"
+#include "core/thread_pool.h"
 #include "core/time.h"
 #include "figure/formation_legion.h"
 #include "game/resource.h"
@@ -33,9 +35,13 @@
 #include "widget/city_bridge.h"
 #include "widget/city_building_ghost.h"
 #include "widget/city_figure.h"
+#include "widget/city_terrain_cache.h"
 
 //#define OFFSET(x,y) (x + grid_size[GAME_ENV] * y)
 
+#define MIN_BAND_HEIGHT 64
+#define FOOTPRINT_BAND_MARGIN 180
+
 static
 const int ADJACENT_OFFSETS_C3[2][4][7] = {
   {
@@ -486,21 +492,15 @@ static void draw_farm_crops(building *b, int x, int y) {
     }
 }
 
-static void draw_footprint(int x, int y, int grid_offset) {
-    if (grid_offset < 0) {
-        image_draw_isometric_footprint_from_draw_tile(image_id_from_group(GROUP_TERRAIN_BLACK), x, y, COLOR_BLACK);
+// everything draw_footprint does besides drawing: it runs on one thread before the footprints are drawn in bands
+static void update_footprint(int x, int y, int grid_offset) {
+    if (grid_offset < 0)
         return;
-    }
     building_construction_record_view_position(x, y, grid_offset);
     if (map_property_is_draw_tile(grid_offset)) {
-        // Valid grid_offset_figure and leftmost tile -> draw
         int building_id = map_building_at(grid_offset);
-        color_t color_mask = 0;
         if (building_id) {
             building *b = building_get(building_id);
-            if (!config_get(CONFIG_UI_VISUAL_FEEDBACK_ON_DELETE) && draw_building_as_deleted(b))
-                color_mask = COLOR_MASK_RED;
-
             int view_x, view_y, view_width, view_height;
             city_view_get_scaled_viewport(&view_x, &view_y, &view_width, &view_height);
             if (x < view_x + 100)
@@ -527,8 +527,25 @@ static void draw_footprint(int x, int y, int grid_offset) {
                 if (image_id > draw_context.image_id_deepwater_last)
                     image_id -= 90;
             }
-            map_image_set(grid_offset, image_id);
+            map_image_set_animation_frame(grid_offset, image_id);
+        }
+    }
+}
+static void draw_footprint(int x, int y, int grid_offset) {
+    if (grid_offset < 0) {
+        image_draw_isometric_footprint_from_draw_tile(image_id_from_group(GROUP_TERRAIN_BLACK), x, y, COLOR_BLACK);
+        return;
+    }
+    if (map_property_is_draw_tile(grid_offset)) {
+        // Valid grid_offset_figure and leftmost tile -> draw
+        int building_id = map_building_at(grid_offset);
+        color_t color_mask = 0;
+        if (building_id) {
+            building *b = building_get(building_id);
+            if (!config_get(CONFIG_UI_VISUAL_FEEDBACK_ON_DELETE) && draw_building_as_deleted(b))
+                color_mask = COLOR_MASK_RED;
         }
+        int image_id = map_image_at(grid_offset);
         if (map_property_is_constructing(grid_offset))
             image_id = image_id_from_group(GROUP_TERRAIN_OVERLAY);
 
@@ -543,6 +560,76 @@ static void draw_footprint(int x, int y, int grid_offset) {
         }
     }
 }
+static int is_animated_water(int image_id) {
+    return (image_id >= draw_context.image_id_water_first && image_id <= draw_context.image_id_water_last)
+           || (image_id >= draw_context.image_id_deepwater_first && image_id <= draw_context.image_id_deepwater_last);
+}
+// the part of draw_footprint that only changes with the tile's image, kept in the terrain cache
+static void draw_cached_footprint(int x, int y, int grid_offset) {
+    if (grid_offset < 0) {
+        image_draw_isometric_footprint_from_draw_tile(image_id_from_group(GROUP_TERRAIN_BLACK), x, y, COLOR_BLACK);
+        return;
+    }
+    if (map_property_is_draw_tile(grid_offset))
+        image_draw_isometric_footprint_from_draw_tile(map_image_at(grid_offset), x, y, 0);
+}
+// redraws the footprints that change without their image changing over the cached ones
+static void draw_live_footprint(int x, int y, int grid_offset) {
+    if (!map_property_is_draw_tile(grid_offset))
+        return;
+    int is_live = map_property_is_constructing(grid_offset) || is_animated_water(map_image_at(grid_offset));
+    int building_id = map_building_at(grid_offset);
+    if (building_id) {
+        building *b = building_get(building_id);
+        is_live = is_live || draw_building_as_deleted(b) || building_is_farm(b->type);
+    }
+    if (is_live)
+        draw_footprint(x, y, grid_offset);
+}
+typedef struct {
+    canvas_type canvas;
+    int clip_x;
+    int clip_y;
+    int clip_width;
+    int clip_height;
+    int band_height;
+} band_context;
+
+static void draw_footprint_band(int band, void *userdata) {
+    const band_context *context = (const band_context *) userdata;
+    graphics_set_active_canvas(context->canvas);
+    int y_start = context->clip_y + band * context->band_height;
+    int y_end = y_start + context->band_height;
+    if (y_end > context->clip_y + context->clip_height)
+        y_end = context->clip_y + context->clip_height;
+    graphics_set_clip_rectangle(context->clip_x, y_start, context->clip_width, y_end - y_start);
+    // footprints and farm crops reach a few tiles above and below their draw tile
+    city_view_foreach_map_tile_in_band(y_start - FOOTPRINT_BAND_MARGIN, y_end + FOOTPRINT_BAND_MARGIN, draw_footprint);
+}
+static void draw_footprints(void) {
+    city_view_foreach_map_tile(update_footprint);
+    if (city_terrain_cache_draw(draw_cached_footprint)) {
+        city_view_foreach_valid_map_tile(draw_live_footprint, 0, 0);
+        return;
+    }
+
+    band_context context;
+    context.canvas = graphics_get_canvas_type();
+    graphics_get_clip_rectangle(&context.clip_x, &context.clip_y, &context.clip_width, &context.clip_height);
+    int num_bands = thread_pool_size();
+    if (context.clip_height < num_bands * MIN_BAND_HEIGHT)
+        num_bands = context.clip_height / MIN_BAND_HEIGHT;
+    if (num_bands <= 1) {
+        city_view_foreach_map_tile(draw_footprint);
+        return;
+    }
+    context.band_height = (context.clip_height + num_bands - 1) / num_bands;
+    // the workers do not track what they change
+    graphics_mark_dirty(context.clip_x, context.clip_y, context.clip_width, context.clip_height);
+    thread_pool_run(num_bands, draw_footprint_band, &context);
+    // this thread drew one of the bands as well
+    graphics_set_clip_rectangle(context.clip_x, context.clip_y, context.clip_width, context.clip_height);
+}
 static void draw_outside_map(int x, int y, int grid_offset) {
     if (grid_offset < 0) {
 //        if (grid_offset == -2)
@@ -1055,21 +1142,31 @@ void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_
 //    graphics_set_clip_rectangle(x - 30, y, map_grid_width() * 30 - 60, map_grid_height() * 15 - 30);
 
     int should_mark_deleting = city_building_ghost_mark_deleting(tile);
-    city_view_foreach_map_tile(draw_footprint);
+    {
+        PROFILE_SCOPE(PROFILER_DRAW_FOOTPRINTS);
+        draw_footprints();
+    }
     if (!should_mark_deleting) {
-        city_view_foreach_valid_map_tile(
-                draw_top,
-                draw_figures,
-                draw_animation
-        );
-        if (!selected_figure_id)
+        {
+            PROFILE_SCOPE(PROFILER_DRAW_TOPS_FIGURES);
+            city_view_foreach_valid_map_tile(
+                    draw_top,
+                    draw_figures,
+                    draw_animation
+            );
+        }
+        if (!selected_figure_id) {
+            PROFILE_SCOPE(PROFILER_DRAW_GHOST);
             city_building_ghost_draw(tile);
+        }
+        PROFILE_SCOPE(PROFILER_DRAW_ELEVATED);
         city_view_foreach_valid_map_tile(
                 draw_elevated_figures,
                 draw_hippodrome_ornaments,
                 draw_debug
         );
     } else {
+        PROFILE_SCOPE(PROFILER_DRAW_DELETING);
         city_view_foreach_map_tile(deletion_draw_terrain_top);
         city_view_foreach_map_tile(deletion_draw_figures_animations);
         city_view_foreach_map_tile(deletion_draw_remaining);
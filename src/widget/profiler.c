@@ -0,0 +1,64 @@
+#include "profiler.h"
+
+#include "core/profiler.h"
+#include "core/string.h"
+#include "graphics/graphics.h"
+#include "graphics/text.h"
+
+#define X_OFFSET 10
+#define Y_OFFSET 40
+#define LINE_HEIGHT 10
+#define NUM_SLOWEST_SLOTS 10
+
+static int find_slowest_slots(int *slots) {
+    int num_slots = 0;
+    for (int slot = 0; slot < PROFILER_NUM_TICK_SLOTS; slot++) {
+        uint64_t max_ns = profiler_get_slot_stats(slot)->max_ns;
+        if (!max_ns)
+            continue;
+        int pos = num_slots;
+        while (pos > 0 && profiler_get_slot_stats(slots[pos - 1])->max_ns < max_ns)
+            pos--;
+        if (pos >= NUM_SLOWEST_SLOTS)
+            continue;
+        if (num_slots < NUM_SLOWEST_SLOTS)
+            num_slots++;
+        for (int i = num_slots - 1; i > pos; i--)
+            slots[i] = slots[i - 1];
+        slots[pos] = slot;
+    }
+    return num_slots;
+}
+
+static void draw_header(const char *text, int y) {
+    text_draw_shadow((uint8_t *) string_from_ascii(text), X_OFFSET, y, COLOR_WHITE);
+}
+
+void widget_profiler_draw(void) {
+    if (!profiler_enabled)
+        return;
+    uint8_t str[32];
+    int slots[NUM_SLOWEST_SLOTS];
+    int num_slots = find_slowest_slots(slots);
+    int height = (PROFILER_MAX_SECTIONS + num_slots + 3) * LINE_HEIGHT + 10;
+    graphics_shade_rect(X_OFFSET - 5, Y_OFFSET - 5, 230, height, 5);
+
+    // microseconds spent during the last second, and the longest single call
+    int y = Y_OFFSET;
+    draw_header("section               total us     max us", y);
+    for (int section = 0; section < PROFILER_MAX_SECTIONS; section++) {
+        const profiler_stats *stats = profiler_get_section_stats((profiler_section) section);
+        y += LINE_HEIGHT;
+        draw_debug_line_double_left(str, X_OFFSET, y, 160, 60, profiler_section_name((profiler_section) section),
+                                    (int) (stats->total_ns / 1000), (int) (stats->max_ns / 1000));
+    }
+    y += 2 * LINE_HEIGHT;
+    draw_header("slowest tick slots    avg us       max us", y);
+    for (int i = 0; i < num_slots; i++) {
+        const profiler_stats *stats = profiler_get_slot_stats(slots[i]);
+        y += LINE_HEIGHT;
+        draw_debug_line(str, X_OFFSET, y, 30, "slot", slots[i]);
+        draw_debug_line_double_left(str, X_OFFSET, y, 160, 60, "",
+                                    (int) (stats->total_ns / stats->calls / 1000), (int) (stats->max_ns / 1000));
+    }
+}
@@ -0,0 +1,9 @@
+#ifndef WIDGET_PROFILER_H
+#define WIDGET_PROFILER_H
+
+/**
+ * Draws the profiler breakdown when the profiler is enabled
+ */
+void widget_profiler_draw(void);
+
+#endif // WIDGET_PROFILER_H
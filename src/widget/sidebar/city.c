@@ -185,6 +185,8 @@ static struct {
 #include "city/data_private.h"
 #include "game/tutorial.h"
 #include "core/string.h"
+#include "figure/route.h"
+#include "map/routing.h"
 
 static void draw_debug_ui(int x, int y) {
     auto time = give_me_da_time();
@@ -274,6 +276,16 @@ static void draw_debug_ui(int x, int y) {
         draw_debug_line_double_left(str, x, y + 215, 90, 40, "v.pixels:", viewdata->viewport.width_pixels, viewdata->viewport.height_pixels);
     }
 
+    /////// ROUTING
+    if (false) {
+        int cl = 90;
+        draw_debug_line(str, x, y + 235, cl, "routes:", map_routing_total_routes_calculated());
+        draw_debug_line(str, x, y + 245, cl, "tiles last:", map_routing_tiles_touched_last());
+        draw_debug_line(str, x, y + 255, cl, "tiles avg:", map_routing_tiles_touched_average());
+        draw_debug_line(str, x, y + 265, cl, "cache hit:", figure_route_cache_hits());
+        draw_debug_line(str, x, y + 275, cl, "cache miss:", figure_route_cache_misses());
+    }
+
     /////// TUTORIAL
     x -= 10;
     y += 150;
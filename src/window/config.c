@@ -25,8 +25,8 @@
 #include "translation/translation.h"
 #include <string.h>
 
-#define NUM_CHECKBOXES 37
-#define CONFIG_PAGES 3
+#define NUM_CHECKBOXES 39
+#define CONFIG_PAGES 4
 #define MAX_LANGUAGE_DIRS 20
 
 #define FIRST_BUTTON_Y 72
@@ -42,7 +42,7 @@
 #define ITEM_Y_OFFSET 60
 #define ITEM_HEIGHT 24
 
-static int options_per_page[CONFIG_PAGES] = {11, 14, 12};
+static int options_per_page[CONFIG_PAGES] = {11, 14, 14, 1};
 
 static void toggle_switch(int id, int param2);
 static void button_language_select(int param1, int param2);
@@ -94,6 +94,9 @@ static generic_button checkbox_buttons[] = {
         {20, 288, 20, 20, toggle_switch, button_none, CONFIG_GP_CH_MULTIPLE_BARRACKS,                   TR_CONFIG_MULTIPLE_BARRACKS},
         {20, 312, 20, 20, toggle_switch, button_none, CONFIG_GP_CH_WAREHOUSES_DONT_ACCEPT,              TR_CONFIG_NOT_ACCEPTING_WAREHOUSES},
         {20, 336, 20, 20, toggle_switch, button_none, CONFIG_GP_CH_HOUSES_DONT_EXPAND_INTO_GARDENS,     TR_CONFIG_HOUSES_DONT_EXPAND_INTO_GARDENS},
+        {20, 360, 20, 20, toggle_switch, button_none, CONFIG_GP_CH_ASTAR_ROUTING,                       TR_CONFIG_ASTAR_ROUTING},
+        {20, 384, 20, 20, toggle_switch, button_none, CONFIG_GP_CH_INCREMENTAL_DESIRABILITY,            TR_CONFIG_INCREMENTAL_DESIRABILITY},
+        {20, 72,  20, 20, toggle_switch, button_none, CONFIG_GP_CH_INCREMENTAL_BUILDING_COUNTS,         TR_CONFIG_INCREMENTAL_BUILDING_COUNTS},
 };
 
 static generic_button language_button = {
@@ -115,6 +118,7 @@ static generic_button page_buttons[] = {
 static int page_names[] = {
         TR_CONFIG_HEADER_UI_CHANGES,
         TR_CONFIG_HEADER_GAMEPLAY_CHANGES,
+        TR_CONFIG_HEADER_GAMEPLAY_CHANGES,
         TR_CONFIG_HEADER_GAMEPLAY_CHANGES
 };
 
@@ -52,6 +52,8 @@ static hotkey_widget hotkey_widgets[] = {
         {HOTKEY_RESIZE_TO_1024,             TR_HOTKEY_RESIZE_TO_1024},
         {HOTKEY_SAVE_SCREENSHOT,            TR_HOTKEY_SAVE_SCREENSHOT},
         {HOTKEY_SAVE_CITY_SCREENSHOT,       TR_HOTKEY_SAVE_CITY_SCREENSHOT},
+        {HOTKEY_TOGGLE_PROFILER,            TR_HOTKEY_TOGGLE_PROFILER},
+        {HOTKEY_DUMP_PROFILER,              TR_HOTKEY_DUMP_PROFILER},
         {HOTKEY_LOAD_FILE,                  TR_HOTKEY_LOAD_FILE},
         {HOTKEY_SAVE_FILE,                  TR_HOTKEY_SAVE_FILE},
         {HOTKEY_HEADER,                     TR_HOTKEY_HEADER_CITY},
@@ -0,0 +1,68 @@
+#include "core/game_environment.h"
+#include "map/grid.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ROUNDS 200
+
+static grid_xx distance_xx = {0, {FS_INT16, FS_INT16}};
+static grid<int16_t> distance_typed;
+
+static int offsets[GRID_SIZE_PH * GRID_SIZE_PH];
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename G>
+static double run(G *g, int64_t *checksum)
+{
+    int total = grid_total_size[GAME_ENV];
+    int64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < total; i++) {
+            int offset = offsets[i];
+            map_grid_set(g, offset, map_grid_get(g, offset) + 1);
+            sum += map_grid_get(g, offset);
+        }
+    }
+    double ns = elapsed_ns(start);
+    *checksum = sum;
+    // one get + one set + one get per iteration
+    return ns / ((double) ROUNDS * total * 3);
+}
+
+int main(int argc, char **argv)
+{
+    init_game_environment(argc > 1 ? atoi(argv[1]) : ENGINE_ENV_PHARAOH, ENGINE_MODE_RELEASE);
+    int total = grid_total_size[GAME_ENV];
+
+    // shuffled offsets so the benchmark measures access cost, not prefetching
+    srand(1);
+    for (int i = 0; i < total; i++)
+        offsets[i] = i;
+    for (int i = total - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = offsets[i];
+        offsets[i] = offsets[j];
+        offsets[j] = tmp;
+    }
+
+    map_grid_clear(&distance_xx);
+    map_grid_clear(&distance_typed);
+
+    int64_t checksum_xx, checksum_typed;
+    double ns_xx = run(&distance_xx, &checksum_xx);
+    double ns_typed = run(&distance_typed, &checksum_typed);
+
+    printf("grid size: %d tiles, %d rounds\n", total, ROUNDS);
+    printf("grid_xx      : %6.2f ns/access (checksum %lld)\n", ns_xx, (long long) checksum_xx);
+    printf("grid<int16_t>: %6.2f ns/access (checksum %lld)\n", ns_typed, (long long) checksum_typed);
+    printf("speedup      : %6.2fx\n", ns_xx / ns_typed);
+
+    return checksum_xx == checksum_typed ? 0 : 1;
+}
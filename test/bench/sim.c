@@ -0,0 +1,166 @@
+#include "core/game_environment.h"
+#include "core/profiler.h"
+#include "core/time.h"
+#include "game/file.h"
+#include "game/game.h"
+#include "game/settings.h"
+#include "game/time.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// advance_tick switches on game_time_tick(): 0 to 49, plus 50 in Pharaoh
+#define NUM_TICK_SLOTS 51
+
+typedef struct {
+    const char *save;
+    int ticks;
+    double seconds;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double max_us;
+    double slot_total_us[NUM_TICK_SLOTS];
+    int slot_count[NUM_TICK_SLOTS];
+} bench_result;
+
+static double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = (size_t) (fraction * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static int run_save(const char *save, int ticks, bench_result *result)
+{
+    memset(result, 0, sizeof(bench_result));
+    result->save = save;
+    if (!game_file_load_saved_game(save)) {
+        printf("Unable to load saved game %s\n", save);
+        return 0;
+    }
+    std::vector<double> latencies;
+    latencies.reserve(ticks);
+
+    // same clock stepping as the autopilot, so every game_run() advances exactly one tick
+    setting_reset_speeds(100, setting_scroll_speed());
+    time_set_millis(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i <= ticks; i++) {
+        int slot = game_time_tick();
+        time_set_millis(2 * i);
+        auto tick_start = std::chrono::steady_clock::now();
+        game_run();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tick_start).count();
+        latencies.push_back(us);
+        if (slot >= 0 && slot < NUM_TICK_SLOTS) {
+            // only the advance_tick part of the tick, as timed by the profiler
+            result->slot_total_us[slot] += profiler_get_last_duration(PROFILER_TICK_SLOT) / 1000.0;
+            result->slot_count[slot]++;
+        }
+    }
+    result->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result->ticks = ticks;
+
+    std::sort(latencies.begin(), latencies.end());
+    result->p50_us = percentile(latencies, 0.50);
+    result->p90_us = percentile(latencies, 0.90);
+    result->p99_us = percentile(latencies, 0.99);
+    result->max_us = latencies.empty() ? 0 : latencies.back();
+    return 1;
+}
+
+static double slot_average(const bench_result *result, int slot)
+{
+    return result->slot_count[slot] ? result->slot_total_us[slot] / result->slot_count[slot] : 0;
+}
+
+static void print_result(const bench_result *result)
+{
+    printf("%s: %d ticks in %.3f s, %.1f ticks/s\n", result->save, result->ticks, result->seconds,
+        result->seconds > 0 ? result->ticks / result->seconds : 0);
+    printf("  latency us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+        result->p50_us, result->p90_us, result->p99_us, result->max_us);
+    printf("  average advance_tick us per tick slot:\n");
+    for (int slot = 0; slot < NUM_TICK_SLOTS; slot++) {
+        printf("  %2d:%9.1f%s", slot, slot_average(result, slot), slot % 5 == 4 || slot == NUM_TICK_SLOTS - 1 ? "\n" : "");
+    }
+}
+
+static void write_json(FILE *fp, const bench_result *results, int num_results)
+{
+    fprintf(fp, "{\n  \"results\": [\n");
+    for (int i = 0; i < num_results; i++) {
+        const bench_result *r = &results[i];
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"save\": \"%s\",\n", r->save);
+        fprintf(fp, "      \"ticks\": %d,\n", r->ticks);
+        fprintf(fp, "      \"seconds\": %.6f,\n", r->seconds);
+        fprintf(fp, "      \"ticks_per_second\": %.3f,\n", r->seconds > 0 ? r->ticks / r->seconds : 0);
+        fprintf(fp, "      \"latency_us\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+            r->p50_us, r->p90_us, r->p99_us, r->max_us);
+        fprintf(fp, "      \"slot_average_us\": [");
+        for (int slot = 0; slot < NUM_TICK_SLOTS; slot++) {
+            fprintf(fp, "%s%.3f", slot ? ", " : "", slot_average(r, slot));
+        }
+        fprintf(fp, "]\n    }%s\n", i < num_results - 1 ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4) {
+        printf("Usage: %s <ticks> <result.json> <save>...\n", argv[0]);
+        return -1;
+    }
+    int ticks = atoi(argv[1]);
+    const char *json_file = argv[2];
+    if (ticks <= 0) {
+        printf("Invalid number of ticks: %s\n", argv[1]);
+        return -1;
+    }
+    // the saves are all Caesar 3 saves
+    init_game_environment(ENGINE_ENV_C3, ENGINE_MODE_RELEASE);
+    // per-slot times come from the advance_tick samples
+    if (!profiler_enabled) {
+        profiler_toggle();
+    }
+    if (!game_pre_init()) {
+        printf("Unable to run Game_preInit\n");
+        return 1;
+    }
+    if (!game_init()) {
+        printf("Unable to run Game_init\n");
+        return 2;
+    }
+
+    int num_saves = argc - 3;
+    std::vector<bench_result> results(num_saves);
+    int num_results = 0;
+    for (int i = 0; i < num_saves; i++) {
+        if (!run_save(argv[3 + i], ticks, &results[num_results])) {
+            return 3;
+        }
+        print_result(&results[num_results]);
+        num_results++;
+    }
+
+    FILE *fp = fopen(json_file, "w");
+    if (!fp) {
+        printf("Unable to write %s\n", json_file);
+        return 4;
+    }
+    write_json(fp, results.data(), num_results);
+    fclose(fp);
+    printf("Results written to %s\n", json_file);
+
+    game_exit();
+    return 0;
+}
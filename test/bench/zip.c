@@ -0,0 +1,104 @@
+#include "core/zip.h"
+#include "sav/sav_compare.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define MAX_SAVE_SIZE 1300000
+#define COMPRESS_BUFFER_SIZE 600000
+
+typedef struct {
+    const uint8_t *data;
+    int length;
+} piece;
+
+static uint8_t save_data[MAX_SAVE_SIZE];
+static uint8_t compressed[COMPRESS_BUFFER_SIZE];
+static uint8_t decompressed[COMPRESS_BUFFER_SIZE];
+
+static double elapsed_s(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// compresses and decompresses every piece, checking that the data survives the round trip
+static int run_level(const std::vector<piece> &pieces, int level, int rounds)
+{
+    int64_t input_bytes = 0;
+    int64_t output_bytes = 0;
+    double compress_s = 0;
+    double decompress_s = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < pieces.size(); i++) {
+            const piece *p = &pieces[i];
+            int compressed_length = COMPRESS_BUFFER_SIZE;
+            auto start = std::chrono::steady_clock::now();
+            if (!zip_compress(p->data, p->length, compressed, &compressed_length, level)) {
+                printf("Level %d: unable to compress piece %d\n", level, (int) i);
+                return 0;
+            }
+            compress_s += elapsed_s(start);
+
+            int decompressed_length = p->length;
+            start = std::chrono::steady_clock::now();
+            if (!zip_decompress(compressed, compressed_length, decompressed, &decompressed_length)) {
+                printf("Level %d: unable to decompress piece %d\n", level, (int) i);
+                return 0;
+            }
+            decompress_s += elapsed_s(start);
+            if (decompressed_length != p->length || memcmp(decompressed, p->data, p->length) != 0) {
+                printf("Level %d: piece %d differs after the round trip\n", level, (int) i);
+                return 0;
+            }
+            input_bytes += p->length;
+            output_bytes += compressed_length;
+        }
+    }
+    double mb = input_bytes / (1024.0 * 1024.0);
+    printf("level %d: ratio %6.2f%%  compress %8.2f MB/s  decompress %8.2f MB/s\n", level,
+           100.0 * output_bytes / input_bytes, mb / compress_s, mb / decompress_s);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        printf("Usage: %s ROUNDS SAVE...\n", argv[0]);
+        return 1;
+    }
+    int rounds = atoi(argv[1]);
+
+    // the compressed parts of all saves, as the game hands them to zip_compress
+    std::vector<std::vector<uint8_t>> saves;
+    std::vector<piece> pieces;
+    for (int s = 2; s < argc; s++) {
+        int length = sav_unpack(argv[s], save_data);
+        if (!length) {
+            return 1;
+        }
+        saves.push_back(std::vector<uint8_t>(save_data, save_data + length));
+    }
+    for (size_t s = 0; s < saves.size(); s++) {
+        int offset = 0;
+        int compressed_part;
+        int length;
+        for (int i = 0; (length = sav_part_length(i, &compressed_part)) != 0; i++) {
+            if (compressed_part) {
+                piece p = {&saves[s][offset], length};
+                pieces.push_back(p);
+            }
+            offset += length;
+        }
+    }
+    printf("%d pieces from %d saves, %d rounds\n", (int) pieces.size(), (int) saves.size(), rounds);
+
+    for (int level = ZIP_LEVEL_ORIGINAL; level <= ZIP_LEVEL_BEST; level++) {
+        if (!run_level(pieces, level, rounds)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "core/game_environment.h"
+#include "figure/figure.h"
+#include "figure/route.h"
+#include "map/grid.h"
+#include "map/routing_terrain.h"
+#include "map/terrain.h"
+
+#include <stdio.h>
+
+#define MAP_SIZE 40
+#define ROAD_Y 10
+#define ROAD_START 5
+#define ROAD_END 20
+
+// static, so everything but the id starts zeroed
+static figure walkers[] = {figure(1), figure(2), figure(3), figure(4)};
+
+static void create_road_map(void)
+{
+    map_grid_data_init(MAP_SIZE, MAP_SIZE, 0, GRID_SIZE_C3 - MAP_SIZE);
+    map_terrain_clear();
+    for (int x = ROAD_START; x <= ROAD_END; x++) {
+        map_terrain_add(map_grid_offset(x, ROAD_Y), TERRAIN_ROAD);
+    }
+    map_routing_update_land();
+    map_routing_passability_changes_clear();
+    figure_route_clear_all();
+}
+
+static void route(figure *f, int src_x, int dst_x)
+{
+    f->tile_x = src_x;
+    f->tile_y = ROAD_Y;
+    f->destination_x = dst_x;
+    f->destination_y = ROAD_Y;
+    f->terrain_usage = TERRAIN_USAGE_ROADS;
+    f->figure_route_add();
+}
+
+static int same_path(const figure *f, const uint8_t *expected, int expected_length)
+{
+    if (f->routing_path_length != expected_length) {
+        return 0;
+    }
+    for (int i = 0; i < expected_length; i++) {
+        if (figure_route_get_direction(f->routing_path_id, i) != expected[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int copy_path(const figure *f, uint8_t *path)
+{
+    for (int i = 0; i < f->routing_path_length; i++) {
+        path[i] = (uint8_t) figure_route_get_direction(f->routing_path_id, i);
+    }
+    return f->routing_path_length;
+}
+
+// A cache hit copies a cached path into a free slot. When that slot still holds another
+// cached route, the cache entry for that route must be dropped, or it serves the copied path.
+static int test_hit_into_cached_slot(void)
+{
+    uint8_t east[ROAD_END - ROAD_START];
+    uint8_t west[ROAD_END - ROAD_START];
+    figure *a = &walkers[0];
+    figure *b = &walkers[1];
+    figure *c = &walkers[2];
+    figure *d = &walkers[3];
+
+    create_road_map();
+    route(a, ROAD_START, ROAD_END);
+    route(b, ROAD_END, ROAD_START);
+    if (a->routing_path_id != 1 || b->routing_path_id != 2 || !a->routing_path_length || !b->routing_path_length) {
+        printf("setup: expected two searched routes in slots 1 and 2, got %d and %d\n",
+            a->routing_path_id, b->routing_path_id);
+        return 0;
+    }
+    int east_length = copy_path(a, east);
+    int west_length = copy_path(b, west);
+
+    // slot 1 is free again, but still holds the cached eastbound route
+    a->route_remove();
+    int hits = figure_route_cache_hits();
+    route(c, ROAD_END, ROAD_START);
+    if (c->routing_path_id != 1 || figure_route_cache_hits() != hits + 1 || !same_path(c, west, west_length)) {
+        printf("westbound route: expected a cache hit copied into slot 1\n");
+        return 0;
+    }
+    route(d, ROAD_START, ROAD_END);
+    if (!same_path(d, east, east_length)) {
+        printf("eastbound route: got the path that was copied over the cached one\n");
+        return 0;
+    }
+    if (figure_route_cache_hits() != hits + 1) {
+        printf("eastbound route: expected a search, the cached path was overwritten\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Asking for the route that is cached in the free slot itself reuses the path without copying
+static int test_hit_into_own_slot(void)
+{
+    uint8_t east[ROAD_END - ROAD_START];
+    figure *a = &walkers[0];
+    figure *b = &walkers[1];
+
+    create_road_map();
+    route(a, ROAD_START, ROAD_END);
+    int east_length = copy_path(a, east);
+    a->route_remove();
+
+    int hits = figure_route_cache_hits();
+    route(b, ROAD_START, ROAD_END);
+    if (b->routing_path_id != 1 || figure_route_cache_hits() != hits + 1 || !same_path(b, east, east_length)) {
+        printf("own slot: expected a cache hit served from slot 1\n");
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    init_game_environment(ENGINE_ENV_C3, ENGINE_MODE_RELEASE);
+    int ok = 1;
+    ok &= test_hit_into_cached_slot();
+    ok &= test_hit_into_own_slot();
+    printf("%s\n", ok ? "route cache: all checks passed" : "route cache: FAILED");
+    return ok ? 0 : 1;
+}
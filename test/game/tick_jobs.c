@@ -0,0 +1,182 @@
+#include "core/game_environment.h"
+#include "game/tick.h"
+#include "game/tick_jobs.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_JOBS 12
+#define NUM_ROUNDS 200
+
+static std::atomic<int> clock_ticks;
+static int started_at[MAX_JOBS];
+static int finished_at[MAX_JOBS];
+static int runs[MAX_JOBS];
+
+#define STAMPED_JOB(n) static void job_##n(void) \
+{ \
+    started_at[n] = clock_ticks++; \
+    runs[n]++; \
+    finished_at[n] = clock_ticks++; \
+}
+STAMPED_JOB(0) STAMPED_JOB(1) STAMPED_JOB(2) STAMPED_JOB(3) STAMPED_JOB(4) STAMPED_JOB(5)
+STAMPED_JOB(6) STAMPED_JOB(7) STAMPED_JOB(8) STAMPED_JOB(9) STAMPED_JOB(10) STAMPED_JOB(11)
+
+static void (*const job_functions[MAX_JOBS])(void) = {
+    job_0, job_1, job_2, job_3, job_4, job_5, job_6, job_7, job_8, job_9, job_10, job_11
+};
+
+static void make_jobs(tick_job *jobs, const int (*data)[2], int num_jobs)
+{
+    for (int i = 0; i < num_jobs; i++) {
+        jobs[i].name = "test";
+        jobs[i].run = job_functions[i];
+        jobs[i].reads = data[i][0];
+        jobs[i].writes = data[i][1];
+    }
+}
+
+static int check_waves(const char *name, const int (*data)[2], int num_jobs, const int *expected_sizes)
+{
+    tick_job jobs[MAX_JOBS];
+    make_jobs(jobs, data, num_jobs);
+    int start = 0;
+    for (int wave = 0; start < num_jobs; wave++) {
+        int size = tick_jobs_wave_size(&jobs[start], num_jobs - start);
+        if (size != expected_sizes[wave]) {
+            printf("%s: wave %d has %d jobs, expected %d\n", name, wave, size, expected_sizes[wave]);
+            return 0;
+        }
+        start += size;
+    }
+    return 1;
+}
+
+static int test_wave_splitting(void)
+{
+    static const int independent[][2] = {
+        {TICK_DATA_BUILDINGS, TICK_DATA_CITY}, {TICK_DATA_TERRAIN, TICK_DATA_ROAD_NETWORK}, {TICK_DATA_RANDOM, 0}
+    };
+    static const int independent_waves[] = {3};
+    static const int write_then_read[][2] = {{0, TICK_DATA_TERRAIN}, {TICK_DATA_TERRAIN, 0}};
+    static const int read_then_write[][2] = {{TICK_DATA_TERRAIN, 0}, {0, TICK_DATA_TERRAIN}};
+    static const int write_then_write[][2] = {{0, TICK_DATA_CITY}, {0, TICK_DATA_CITY}};
+    static const int split_waves[] = {1, 1};
+    static const int read_then_read[][2] = {{TICK_DATA_ALL, 0}, {TICK_DATA_ALL, 0}};
+    static const int read_waves[] = {2};
+    static const int unchecked[][2] = {{TICK_DATA_CITY, 0}, {TICK_DATA_ALL, TICK_DATA_ALL}, {TICK_DATA_CITY, 0}};
+    static const int unchecked_waves[] = {1, 1, 1};
+    // the third job doesn't conflict with the first one, but may not move before the second one
+    static const int no_reordering[][2] = {
+        {0, TICK_DATA_TERRAIN}, {TICK_DATA_TERRAIN, TICK_DATA_DESIRABILITY}, {TICK_DATA_CITY, TICK_DATA_CITY}
+    };
+    static const int no_reordering_waves[] = {1, 2};
+    static const int many[MAX_JOBS][2] = {
+        {0, 1 << 0}, {0, 1 << 1}, {0, 1 << 2}, {0, 1 << 3}, {0, 1 << 4}, {0, 1 << 5},
+        {0, 1 << 6}, {0, 1 << 7}, {0, 1 << 8}, {0, 1 << 9}, {0, 1 << 10}, {0, 1 << 11}
+    };
+    static const int many_waves[] = {8, 4};
+
+    tick_job jobs[1];
+    if (tick_jobs_wave_size(jobs, 0) != 0) {
+        printf("no jobs: expected an empty wave\n");
+        return 0;
+    }
+    int ok = 1;
+    ok &= check_waves("independent", independent, 3, independent_waves);
+    ok &= check_waves("write then read", write_then_read, 2, split_waves);
+    ok &= check_waves("read then write", read_then_write, 2, split_waves);
+    ok &= check_waves("write then write", write_then_write, 2, split_waves);
+    ok &= check_waves("read then read", read_then_read, 2, read_waves);
+    ok &= check_waves("unchecked", unchecked, 3, unchecked_waves);
+    ok &= check_waves("no reordering", no_reordering, 3, no_reordering_waves);
+    ok &= check_waves("wave limit", many, MAX_JOBS, many_waves);
+    return ok;
+}
+
+static int conflict(const int *a, const int *b)
+{
+    return (a[1] & (b[0] | b[1])) || (b[1] & a[0]);
+}
+
+// every job runs once, and a job never starts before an earlier job it conflicts with is done
+static int test_order(void)
+{
+    static const int data[][2] = {
+        {TICK_DATA_BUILDINGS | TICK_DATA_TERRAIN, TICK_DATA_TERRAIN},
+        {TICK_DATA_BUILDINGS, TICK_DATA_CITY},
+        {TICK_DATA_TERRAIN, TICK_DATA_ROAD_NETWORK},
+        {TICK_DATA_CITY, TICK_DATA_DESIRABILITY},
+        {TICK_DATA_BUILDINGS, TICK_DATA_BUILDINGS},
+        {TICK_DATA_RANDOM, TICK_DATA_RANDOM},
+        {TICK_DATA_ALL, TICK_DATA_ALL},
+        {TICK_DATA_TERRAIN, 0},
+        {TICK_DATA_DESIRABILITY, 0},
+    };
+    int num_jobs = sizeof(data) / sizeof(data[0]);
+    tick_job jobs[MAX_JOBS];
+    make_jobs(jobs, data, num_jobs);
+    for (int round = 0; round < NUM_ROUNDS; round++) {
+        clock_ticks = 0;
+        memset(runs, 0, sizeof(runs));
+        tick_jobs_run(jobs, num_jobs);
+        for (int j = 0; j < num_jobs; j++) {
+            if (runs[j] != 1) {
+                printf("order: job %d ran %d times\n", j, runs[j]);
+                return 0;
+            }
+            for (int i = 0; i < j; i++) {
+                if (conflict(data[i], data[j]) && finished_at[i] > started_at[j]) {
+                    printf("order: job %d started before job %d finished\n", j, i);
+                    return 0;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+static int check_tick(int tick, int expected_jobs, int expected_first_wave)
+{
+    tick_job jobs[MAX_TICK_JOBS];
+    int num_jobs = game_tick_get_jobs(tick, jobs);
+    if (num_jobs != expected_jobs) {
+        printf("env %d tick %d: %d jobs, expected %d\n", GAME_ENV, tick, num_jobs, expected_jobs);
+        return 0;
+    }
+    int wave_size = tick_jobs_wave_size(jobs, num_jobs);
+    if (wave_size != expected_first_wave) {
+        printf("env %d tick %d: first wave has %d jobs, expected %d\n", GAME_ENV, tick, wave_size,
+            expected_first_wave);
+        return 0;
+    }
+    return 1;
+}
+
+// the stages the tick declares: only the floodplains and the culture averages overlap
+static int test_tick_slots(void)
+{
+    int ok = 1;
+    init_game_environment(ENGINE_ENV_PHARAOH, ENGINE_MODE_RELEASE);
+    ok &= check_tick(0, 1, 1);
+    ok &= check_tick(7, 2, 1);
+    ok &= check_tick(28, 2, 1);
+    ok &= check_tick(37, 2, 1);
+    ok &= check_tick(49, 2, 2);
+    init_game_environment(ENGINE_ENV_C3, ENGINE_MODE_RELEASE);
+    ok &= check_tick(0, 0, 0);
+    ok &= check_tick(7, 1, 1);
+    ok &= check_tick(49, 1, 1);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int ok = 1;
+    ok &= test_wave_splitting();
+    ok &= test_order();
+    ok &= test_tick_slots();
+    printf("%s\n", ok ? "tick jobs: all checks passed" : "tick jobs: FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include "graphics/blit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SPAN 70
+#define NUM_ROUNDS 20000
+
+// spans are written with an offset into a larger buffer, so unaligned starts and the guard pixels are checked too
+#define BUFFER_SIZE (MAX_SPAN + 16)
+
+static color_t random_color(void)
+{
+    return ((color_t) (rand() & 0xffff) << 16) | (color_t) (rand() & 0xffff);
+}
+
+static void fill_random(color_t *buffer, int size)
+{
+    for (int i = 0; i < size; i++) {
+        buffer[i] = random_color();
+    }
+}
+
+static int compare(const char *kernel, const blit_functions *reference, const blit_functions *tested,
+                   const color_t *expected, const color_t *actual, int offset, int num_pixels)
+{
+    if (memcmp(expected, actual, BUFFER_SIZE * sizeof(color_t)) == 0) {
+        return 1;
+    }
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        if (expected[i] != actual[i]) {
+            printf("%s: %s differs from %s at pixel %d (offset %d, %d pixels): %08x != %08x\n",
+                kernel, tested->name, reference->name, i, offset, num_pixels, actual[i], expected[i]);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int test_functions(const blit_functions *reference, const blit_functions *tested)
+{
+    color_t src[BUFFER_SIZE];
+    color_t dst[BUFFER_SIZE];
+    color_t expected[BUFFER_SIZE];
+    color_t actual[BUFFER_SIZE];
+    int ok = 1;
+    for (int round = 0; round < NUM_ROUNDS && ok; round++) {
+        int num_pixels = rand() % (MAX_SPAN + 1);
+        int offset = rand() % (BUFFER_SIZE - num_pixels + 1);
+        color_t color = random_color();
+        color_t alpha_color = (color & 0x00ffffff) | ((color_t) (1 + rand() % 254) << 24);
+        fill_random(src, BUFFER_SIZE);
+        fill_random(dst, BUFFER_SIZE);
+
+        memcpy(expected, dst, sizeof(dst));
+        memcpy(actual, dst, sizeof(dst));
+        reference->copy(expected + offset, src, num_pixels);
+        tested->copy(actual + offset, src, num_pixels);
+        ok &= compare("copy", reference, tested, expected, actual, offset, num_pixels);
+
+        memcpy(expected, dst, sizeof(dst));
+        memcpy(actual, dst, sizeof(dst));
+        reference->copy_mirrored(expected + offset, src, num_pixels);
+        tested->copy_mirrored(actual + offset, src, num_pixels);
+        ok &= compare("copy_mirrored", reference, tested, expected, actual, offset, num_pixels);
+
+        memcpy(expected, dst, sizeof(dst));
+        memcpy(actual, dst, sizeof(dst));
+        reference->fill(expected + offset, color, num_pixels);
+        tested->fill(actual + offset, color, num_pixels);
+        ok &= compare("fill", reference, tested, expected, actual, offset, num_pixels);
+
+        memcpy(expected, dst, sizeof(dst));
+        memcpy(actual, dst, sizeof(dst));
+        reference->and_src(expected + offset, src, color, num_pixels);
+        tested->and_src(actual + offset, src, color, num_pixels);
+        ok &= compare("and_src", reference, tested, expected, actual, offset, num_pixels);
+
+        memcpy(expected, dst, sizeof(dst));
+        memcpy(actual, dst, sizeof(dst));
+        reference->and_dst(expected + offset, color, num_pixels);
+        tested->and_dst(actual + offset, color, num_pixels);
+        ok &= compare("and_dst", reference, tested, expected, actual, offset, num_pixels);
+
+        memcpy(expected, dst, sizeof(dst));
+        memcpy(actual, dst, sizeof(dst));
+        reference->blend_alpha(expected + offset, alpha_color, num_pixels);
+        tested->blend_alpha(actual + offset, alpha_color, num_pixels);
+        ok &= compare("blend_alpha", reference, tested, expected, actual, offset, num_pixels);
+    }
+    return ok;
+}
+
+int main(void)
+{
+    int num_functions;
+    const blit_functions *const *functions = blit_get_all(&num_functions);
+    int failed = 0;
+    srand(1234);
+    for (int i = 1; i < num_functions; i++) {
+        if (test_functions(functions[0], functions[i])) {
+            printf("%s matches %s\n", functions[i]->name, functions[0]->name);
+        } else {
+            failed = 1;
+        }
+    }
+    printf("Using %s kernels\n", blit_get()->name);
+    return failed;
+}
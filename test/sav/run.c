@@ -1,4 +1,5 @@
 #include "core/backtrace.h"
+#include "core/game_environment.h"
 #include "core/time.h"
 #include "game/file.h"
 #include "game/game.h"
@@ -39,6 +40,8 @@ static int run_autopilot(const char *input_saved_game, const char *output_saved_
     printf("Running autopilot: %s --> %s in %d ticks\n", input_saved_game, output_saved_game, ticks_to_run);
     signal(SIGSEGV, handler);
 
+    // the test saves are all Caesar 3 saves
+    init_game_environment(ENGINE_ENV_C3, ENGINE_MODE_RELEASE);
     if (!game_pre_init()) {
         printf("Unable to run Game_preInit\n");
         return 1;
@@ -1,3 +1,5 @@
+#include "sav_compare.h"
+
 #include "../src/core/zip.h"
 
 #include <stdio.h>
@@ -293,7 +295,7 @@ static int read_compressed_chunk(FILE *fp, void *buffer, int bytes_to_read)
     return 1;
 }
 
-static int unpack(const char *filename, unsigned char *buffer)
+int sav_unpack(const char *filename, unsigned char *buffer)
 {
     FILE *fp = fopen(filename, "rb");
     if (!fp) {
@@ -319,7 +321,13 @@ static int unpack(const char *filename, unsigned char *buffer)
     return offset;
 }
 
-static int has_adjacent_int(int part_offset, int int)
+int sav_part_length(int index, int *compressed)
+{
+    *compressed = save_game_parts[index].compressed;
+    return save_game_parts[index].length_in_bytes;
+}
+
+static int has_adjacent_building_type(int part_offset, int building_type)
 {
     int grid_offset = part_offset / 2;
     const int adjacent_tiles[] = { -162, 1, 162, -1 };
@@ -332,7 +340,7 @@ static int has_adjacent_int(int part_offset, int int)
         int building_id = to_ushort(&file1_data[offset_of_part("building_grid") + adjacent_offset * 2]);
         int building_offset = offset_of_part("buildings") + building_id * 128;
         int type = to_ushort(&file1_data[building_offset + 10]);
-        if (type == int) {
+        if (type == building_type) {
             return 1;
         }
     }
@@ -379,7 +387,7 @@ static int is_exception_image_grid(int global_offset, int part_offset)
     // Exception for roads next to a granary: in julius the dirt roads and paved roads lead
     // into the granary, while in Caesar 3 they do not. Therefore we do not check roads that
     // are adjacent to a granary (building type 71).
-    if (both_between(v1, v2, 591, 657) && has_adjacent_int(part_offset, 71)) {
+    if (both_between(v1, v2, 591, 657) && has_adjacent_building_type(part_offset, 71)) {
         return 1;
     }
     return 0;
@@ -527,8 +535,8 @@ static int compare(void)
 
 int compare_files(const char *file1, const char *file2)
 {
-    int length1 = unpack(file1, file1_data);
-    int length2 = unpack(file2, file2_data);
+    int length1 = sav_unpack(file1, file1_data);
+    int length2 = sav_unpack(file2, file2_data);
     if (length1 && length1 == length2) {
         return compare();
     } else {
@@ -3,4 +3,17 @@
 
 int compare_files(const char *file1, const char *file2);
 
+/**
+ * Reads all parts of a saved game into buffer, decompressing the compressed ones
+ * @return Total length of the parts, 0 on error
+ */
+int sav_unpack(const char *filename, unsigned char *buffer);
+
+/**
+ * Gets the length of a part of a saved game, in file order
+ * @param compressed Set to 1 when the part is stored compressed
+ * @return Length in bytes, 0 past the last part
+ */
+int sav_part_length(int index, int *compressed);
+
 #endif // SAV_COMPARE_H
@@ -0,0 +1,20 @@
+#include "core/game_environment.h"
+
+int GAME_ENV = ENGINE_ENV_PHARAOH;
+int DEBUG_MODE = ENGINE_MODE_RELEASE;
+
+void init_game_environment(int env, int mode)
+{
+    GAME_ENV = env;
+    DEBUG_MODE = mode;
+}
+
+const char *get_game_title(void)
+{
+    return "Pharaoh";
+}
+
+const char *get_engine_pref_path(void)
+{
+    return "data_dir_pharaoh.txt";
+}
@@ -33,12 +33,14 @@ static int groups[] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
+int terrain_ph_offset = 0;
+
 int image_init(void)
 {
     return 1;
 }
 
-int image_load_climate(int climate_id, int is_editor, int force_reload)
+int image_load_main(int climate_id, int is_editor, int force_reload)
 {
     return 1;
 }
@@ -53,12 +55,18 @@ int image_load_enemy(int enemy_id)
     return 1;
 }
 
-int image_group(int group)
+int image_id_from_group(int group)
 {
+    if (group < 0 || group >= (int) (sizeof(groups) / sizeof(groups[0]))) {
+        return 0;
+    }
     return groups[group];
 }
 
-const image *image_get(int id)
+const image *image_get(int id, int mode)
 {
     return 0;
 }
+
+void image_trim_lazy_data(void)
+{}
@@ -1,5 +1,7 @@
 #include "core/log.h"
 
+#include "SDL.h"
+
 #include <stdio.h>
 
 static void print_message(const char *msg, const char *param_str, int param_int)
@@ -25,3 +27,6 @@ void log_error(const char *msg, const char *param_str, int param_int)
     printf("ERROR: ");
     print_message(msg, param_str, param_int);
 }
+
+void SDL_Log(const char *fmt, ...)
+{}
@@ -165,7 +165,7 @@ const model_building *model_get_building(int type)
     return &buildings[type];
 }
 
-const model_house *model_get_house(house_level level)
+const model_house *model_get_house(int level)
 {
     return &houses[level];
 }
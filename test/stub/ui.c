@@ -1,8 +1,13 @@
+#include "figure/figure.h"
+#include "graphics/image.h"
 #include "graphics/window.h"
 #include "window/message_dialog.h"
 #include "window/popup_dialog.h"
 #include "window/mission_end.h"
 #include "window/victory_dialog.h"
+#include "widget/profiler.h"
+#include "widget/sidebar/city.h"
+#include "window/console.h"
 
 #include "city/victory.h"
 
@@ -61,6 +66,9 @@ void window_popup_dialog_show(popup_dialog_type type, void (*okFunc)(int), int h
 void widget_minimap_invalidate(void)
 {}
 
+void widget_profiler_draw(void)
+{}
+
 int window_building_info_get_int(void)
 {
     return 0;
@@ -69,5 +77,19 @@ int window_building_info_get_int(void)
 void window_city_show(void)
 {}
 
-void window_console_show(int type, int dialog_type)
+void window_console_show(void)
+{}
+
+void widget_sidebar_city_release_build_buttons(void)
+{}
+
+void image_draw_from_below(int image_id, int x, int y, color_t color_mask)
 {}
+
+void image_draw_isometric_footprint(int image_id, int x, int y, color_t color_mask)
+{}
+
+bool figure::has_figure_color()
+{
+    return false;
+}